@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <cstdint>
 
 using std::string;
 using std::vector;
@@ -61,6 +62,7 @@ namespace splashkit_lib
         DISPLAY_PTR =               0x44495350, //'DISP';
         QUERY_PTR =                 0x51555259, //'QURY';
         JSON_PTR =                  0x4a534f4e, //'JSON';
+        TEXT_LAYOUT_PTR =           0x544c4159, //'TLAY';
         NONE_PTR =                  0x4e4f4e45  //'NONE';
     };
 
@@ -141,6 +143,41 @@ namespace splashkit_lib
         bool        cancelled_text_reading;
     };
 
+    // Opaque area of a bitmap cell, inclusive -- empty when right < left
+    struct _mask_bounds
+    {
+        int left, top, right, bottom;
+    };
+
+    // What a block of the collision mask contains, see MASK_BLOCK_SIZE
+    enum _mask_block_state
+    {
+        MASK_BLOCK_EMPTY,
+        MASK_BLOCK_MIXED,
+        MASK_BLOCK_FULL
+    };
+
+    // Pixel mask used for pixel level collisions, with 1 bit per pixel.
+    // Each row starts on a new word. See collision_mask.h
+    struct _collision_mask
+    {
+        int width, height;
+        int words_per_row;
+        uint64_t *bits;
+
+        int *row_first;     // First opaque x in each row, width when none
+        int *row_last;      // Last opaque x in each row, -1 when none
+
+        int cell_count;
+        _mask_bounds *cell_bounds;  // Opaque area within each cell
+
+        // Coarse blocks over each cell, used to skip or accept whole areas
+        // in rotated and scaled collisions. Each cell has block_cols *
+        // block_rows _mask_block_state values, starting from its top left.
+        int block_cols, block_rows;
+        unsigned char *blocks;
+    };
+
     struct _bitmap_data
     {
         pointer_identifier  id;
@@ -154,7 +191,7 @@ namespace splashkit_lib
         int cell_rows;   // The rows of cells in the bitmap
         int cell_count;  // The total number of cells in the bitmap
 
-        bool *pixel_mask;   // Pixel mask used for pixel level collisions
+        _collision_mask *pixel_mask;   // Pixel mask used for pixel level collisions
     };
 
     struct sk_font_data
@@ -286,12 +323,24 @@ namespace splashkit_lib
         animation_frame *next;    // What is the next frame in this animation
     };
 
+    // The frames an animation passes through, flattened from the linked
+    // frames so that any elapsed time can be mapped to a frame with a binary
+    // search.
+    struct animation_sequence
+    {
+        vector<int> frames;         // Frame indexes in the order they are played
+        vector<double> end_times;   // Cumulative time at which each of these frames ends
+        int loop_start;             // The position the sequence loops back to, or -1 if it ends
+    };
+
     struct _animation_data
     {
         pointer_identifier id;
         animation_frame *first_frame;       // Where did it start?
         animation_frame *current_frame;     // Where is the animation up to
         animation_frame *last_frame;        // The last frame used, so last image can be drawn
+        const animation_sequence *sequence; // The flattened frames of the current animation
+        int sequence_index;                 // The position of current_frame within the sequence
         float frame_time;                   // How long have we spent in this frame?
         bool entered_frame;                 // Did we just enter this frame? (can be used for sound playing)
         animation_script script;            // Which script was it created from?
@@ -308,6 +357,7 @@ namespace splashkit_lib
         vector<string> animation_names;     // The names of the animations
         vector<int> animations;             // The starting index of the animations in this template.
         vector<animation_frame> frames;  // The frames of the animations within this template.
+        vector<animation_sequence> sequences;   // The flattened frames of each animation, matching animations
 
         vector<animation>   anim_objs;         // The animations created from this script
     };
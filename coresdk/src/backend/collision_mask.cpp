@@ -0,0 +1,270 @@
+//
+//  collision_mask.cpp
+//  splashkit
+//
+//  Bit packed masks of the opaque pixels in a bitmap, used for pixel level
+//  collisions.
+//
+
+#include "collision_mask.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+namespace splashkit_lib
+{
+    // Index of the lowest and highest set bits in a non-zero word
+    static inline int _lowest_bit(uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(word);
+#else
+        int result = 0;
+        while ( not (word & 1) ) { word >>= 1; result++; }
+        return result;
+#endif
+    }
+
+    static inline int _bit_count(uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        int result = 0;
+        for ( ; word; word &= word - 1) result++;
+        return result;
+#endif
+    }
+
+    static inline int _highest_bit(uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return MASK_WORD_BITS - 1 - __builtin_clzll(word);
+#else
+        int result = MASK_WORD_BITS - 1;
+        while ( not (word >> result) ) result--;
+        return result;
+#endif
+    }
+
+    _collision_mask *create_collision_mask(int width, int height)
+    {
+        _collision_mask *result = (_collision_mask *) malloc(sizeof(_collision_mask));
+
+        result->width = width;
+        result->height = height;
+        result->words_per_row = (width + MASK_WORD_BITS - 1) / MASK_WORD_BITS;
+        result->bits = (uint64_t *) calloc(static_cast<size_t>(result->words_per_row) * height, sizeof(uint64_t));
+        result->row_first = (int *) malloc(sizeof(int) * height);
+        result->row_last = (int *) malloc(sizeof(int) * height);
+        result->cell_count = 0;
+        result->cell_bounds = nullptr;
+        result->block_cols = 0;
+        result->block_rows = 0;
+        result->blocks = nullptr;
+
+        return result;
+    }
+
+    void free_collision_mask(_collision_mask *mask)
+    {
+        if ( not mask ) return;
+
+        free(mask->bits);
+        free(mask->row_first);
+        free(mask->row_last);
+        free(mask->cell_bounds);
+        free(mask->blocks);
+        free(mask);
+    }
+
+    void fill_collision_mask(_collision_mask *mask, const int *pixels)
+    {
+        memset(mask->bits, 0, sizeof(uint64_t) * mask->words_per_row * mask->height);
+
+        for (int y = 0; y < mask->height; y++)
+        {
+            const int *src = pixels + y * mask->width;
+            uint64_t *row = mask->bits + y * mask->words_per_row;
+            int first = mask->width, last = -1;
+
+            for (int x = 0; x < mask->width; x++)
+            {
+                // opaque when alpha is over half
+                if ( (src[x] & 0x000000FF) > 0x0000007F )
+                {
+                    row[x / MASK_WORD_BITS] |= uint64_t(1) << (x % MASK_WORD_BITS);
+                    if ( first > x ) first = x;
+                    last = x;
+                }
+            }
+
+            mask->row_first[y] = first;
+            mask->row_last[y] = last;
+        }
+    }
+
+    bool collision_mask_row_span(const _collision_mask *mask, int y, int x0, int x1, int &first, int &last)
+    {
+        if ( y < 0 or y >= mask->height ) return false;
+
+        // clamp to the opaque part of the row
+        if ( x0 < mask->row_first[y] ) x0 = mask->row_first[y];
+        if ( x1 > mask->row_last[y] ) x1 = mask->row_last[y];
+        if ( x1 < x0 ) return false;
+
+        const uint64_t *row = mask->bits + y * mask->words_per_row;
+        int w0 = x0 / MASK_WORD_BITS, w1 = x1 / MASK_WORD_BITS;
+
+        // mask off bits outside x0..x1 in the end words
+        uint64_t lo_mask = ~uint64_t(0) << (x0 % MASK_WORD_BITS);
+        uint64_t hi_mask = ~uint64_t(0) >> (MASK_WORD_BITS - 1 - x1 % MASK_WORD_BITS);
+
+        first = -1;
+        for (int w = w0; w <= w1; w++)
+        {
+            uint64_t word = row[w];
+            if ( w == w0 ) word &= lo_mask;
+            if ( w == w1 ) word &= hi_mask;
+            if ( word ) { first = w * MASK_WORD_BITS + _lowest_bit(word); break; }
+        }
+
+        if ( first < 0 ) return false;
+
+        for (int w = w1; w >= w0; w--)
+        {
+            uint64_t word = row[w];
+            if ( w == w0 ) word &= lo_mask;
+            if ( w == w1 ) word &= hi_mask;
+            if ( word ) { last = w * MASK_WORD_BITS + _highest_bit(word); break; }
+        }
+
+        return true;
+    }
+
+    // The 64 bits of a row starting at bit pos, which need not be word aligned
+    static inline uint64_t _row_bits(const uint64_t *row, int words, int pos)
+    {
+        int w = pos / MASK_WORD_BITS, shift = pos % MASK_WORD_BITS;
+
+        uint64_t result = row[w] >> shift;
+        if ( shift and w + 1 < words )
+            result |= row[w + 1] << (MASK_WORD_BITS - shift);
+
+        return result;
+    }
+
+    bool collision_masks_overlap(const _collision_mask *mask1, int x1, int y1, const _collision_mask *mask2, int x2, int y2, int w, int h)
+    {
+        for (int y = 0; y < h; y++)
+        {
+            int r1 = y1 + y, r2 = y2 + y;
+
+            // only the part of the area where both rows have opaque pixels
+            int start = std::max(mask1->row_first[r1] - x1, mask2->row_first[r2] - x2);
+            int end = std::min(mask1->row_last[r1] - x1, mask2->row_last[r2] - x2);
+            if ( start < 0 ) start = 0;
+            if ( end > w - 1 ) end = w - 1;
+
+            const uint64_t *row1 = mask1->bits + r1 * mask1->words_per_row;
+            const uint64_t *row2 = mask2->bits + r2 * mask2->words_per_row;
+
+            for (int x = start; x <= end; x += MASK_WORD_BITS)
+            {
+                uint64_t both = _row_bits(row1, mask1->words_per_row, x1 + x) & _row_bits(row2, mask2->words_per_row, x2 + x);
+
+                // ignore bits past the end of the area
+                int remaining = end - x + 1;
+                if ( remaining < MASK_WORD_BITS )
+                    both &= (uint64_t(1) << remaining) - 1;
+
+                if ( both ) return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Classify each block of each cell as empty, mixed or full
+    static void _update_mask_blocks(_collision_mask *mask, int cell_w, int cell_h, int cols, int count)
+    {
+        mask->block_cols = (cell_w + MASK_BLOCK_SIZE - 1) / MASK_BLOCK_SIZE;
+        mask->block_rows = (cell_h + MASK_BLOCK_SIZE - 1) / MASK_BLOCK_SIZE;
+
+        int per_cell = mask->block_cols * mask->block_rows;
+
+        free(mask->blocks);
+        mask->blocks = nullptr;
+        if ( per_cell <= 0 or count <= 0 ) return;
+
+        mask->blocks = (unsigned char *) malloc(static_cast<size_t>(per_cell) * count);
+
+        for (int cell = 0; cell < count; cell++)
+        {
+            int cx = (cell % cols) * cell_w;
+            int cy = (cell / cols) * cell_h;
+            unsigned char *states = mask->blocks + cell * per_cell;
+
+            for (int by = 0; by < mask->block_rows; by++)
+            {
+                for (int bx = 0; bx < mask->block_cols; bx++)
+                {
+                    // the part of the block inside the cell and the mask
+                    int x0 = cx + bx * MASK_BLOCK_SIZE, y0 = cy + by * MASK_BLOCK_SIZE;
+                    int x1 = std::min(std::min(x0 + MASK_BLOCK_SIZE, cx + cell_w), mask->width);
+                    int y1 = std::min(std::min(y0 + MASK_BLOCK_SIZE, cy + cell_h), mask->height);
+
+                    int opaque = 0, total = (x1 - x0) * (y1 - y0);
+
+                    for (int y = y0; y < y1 and x1 > x0; y++)
+                    {
+                        uint64_t bits = _row_bits(mask->bits + y * mask->words_per_row, mask->words_per_row, x0);
+                        opaque += _bit_count(bits & ((uint64_t(1) << (x1 - x0)) - 1));
+                    }
+
+                    if ( opaque == 0 or total <= 0 )
+                        states[by * mask->block_cols + bx] = MASK_BLOCK_EMPTY;
+                    else if ( opaque == total )
+                        states[by * mask->block_cols + bx] = MASK_BLOCK_FULL;
+                    else
+                        states[by * mask->block_cols + bx] = MASK_BLOCK_MIXED;
+                }
+            }
+        }
+    }
+
+    void update_collision_mask_cells(_collision_mask *mask, int cell_w, int cell_h, int cols, int count)
+    {
+        if ( count < 0 ) count = 0;
+
+        mask->cell_bounds = (_mask_bounds *) realloc(mask->cell_bounds, sizeof(_mask_bounds) * (count > 0 ? count : 1));
+        mask->cell_count = count;
+
+        if ( cols <= 0 ) cols = 1;
+
+        for (int cell = 0; cell < count; cell++)
+        {
+            int cx = (cell % cols) * cell_w;
+            int cy = (cell / cols) * cell_h;
+
+            // relative to the cell, empty when right < left
+            _mask_bounds b = { cell_w, cell_h, -1, -1 };
+
+            for (int y = 0; y < cell_h; y++)
+            {
+                int first, last;
+                if ( not collision_mask_row_span(mask, cy + y, cx, cx + cell_w - 1, first, last) ) continue;
+
+                if ( b.left > first - cx ) b.left = first - cx;
+                if ( b.right < last - cx ) b.right = last - cx;
+                if ( b.top > y ) b.top = y;
+                b.bottom = y;
+            }
+
+            mask->cell_bounds[cell] = b;
+        }
+
+        _update_mask_blocks(mask, cell_w, cell_h, cols, count);
+    }
+}
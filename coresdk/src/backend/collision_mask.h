@@ -0,0 +1,56 @@
+//
+//  collision_mask.h
+//  splashkit
+//
+//  Bit packed masks of the opaque pixels in a bitmap, used for pixel level
+//  collisions.
+//
+
+#ifndef collision_mask_h
+#define collision_mask_h
+
+#include "backend_types.h"
+
+#include <cstdint>
+
+namespace splashkit_lib
+{
+    // Bits per mask word
+#define MASK_WORD_BITS 64
+
+    // Width and height of the coarse blocks over each cell
+#define MASK_BLOCK_SIZE 16
+
+    _collision_mask *create_collision_mask(int width, int height);
+    void free_collision_mask(_collision_mask *mask);
+
+    // Set the mask from pixels read with sk_to_pixels (width * height RGBA ints)
+    void fill_collision_mask(_collision_mask *mask, const int *pixels);
+
+    // Recalculate the opaque bounds of each cell, after the mask or cell details change
+    void update_collision_mask_cells(_collision_mask *mask, int cell_w, int cell_h, int cols, int count);
+
+    // Find the first and last opaque pixels in row y between x0 and x1 (inclusive)
+    bool collision_mask_row_span(const _collision_mask *mask, int y, int x0, int x1, int &first, int &last);
+
+    // Check if a w x h area at (x1, y1) in mask1 shares an opaque pixel with
+    // the same sized area at (x2, y2) in mask2. Compares 64 pixels at a time.
+    bool collision_masks_overlap(const _collision_mask *mask1, int x1, int y1, const _collision_mask *mask2, int x2, int y2, int w, int h);
+
+    // The block states for a cell, or nullptr if the cell has none
+    inline const unsigned char *collision_mask_cell_blocks(const _collision_mask *mask, int cell)
+    {
+        if ( cell < 0 or cell >= mask->cell_count or not mask->blocks ) return nullptr;
+
+        return mask->blocks + cell * mask->block_cols * mask->block_rows;
+    }
+
+    inline bool collision_mask_pixel(const _collision_mask *mask, int x, int y)
+    {
+        if ( x < 0 or y < 0 or x >= mask->width or y >= mask->height ) return false;
+
+        const uint64_t *row = mask->bits + y * mask->words_per_row;
+        return (row[x / MASK_WORD_BITS] >> (x % MASK_WORD_BITS)) & 1;
+    }
+}
+#endif /* collision_mask_h */
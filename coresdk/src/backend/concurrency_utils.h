@@ -12,7 +12,9 @@
 #include <mutex>
 #include <thread>
 #include <condition_variable>
+#include <functional>
 #include <queue>
+#include <vector>
 
 using std::mutex;
 using std::thread;
@@ -116,5 +118,93 @@ namespace splashkit_lib
         }
         
     };
+
+    /**
+     * A fixed set of threads that run jobs taken from a channel. Use
+     * `run_all` to split work into jobs and wait for all of them to finish.
+     */
+    class worker_pool
+    {
+    private:
+        std::vector<thread> _workers;
+        channel<std::function<void()>> _jobs;
+
+        void work()
+        {
+            while (true)
+            {
+                std::function<void()> job = _jobs.take();
+                if (not job) return;    // an empty job asks the worker to stop
+                job();
+            }
+        }
+
+    public:
+        explicit worker_pool(unsigned int count)
+        {
+            if (count == 0) count = 1;
+            for (unsigned int i = 0; i < count; i++)
+            {
+                _workers.push_back(thread(&worker_pool::work, this));
+            }
+        }
+
+        ~worker_pool()
+        {
+            for (size_t i = 0; i < _workers.size(); i++)
+            {
+                _jobs.put(nullptr);
+            }
+
+            for (thread &worker : _workers)
+            {
+                worker.join();
+            }
+        }
+
+        size_t size() const
+        {
+            return _workers.size();
+        }
+
+        // Queues job to run on the next free worker, returning straight
+        // away. The caller is responsible for finding out when it is done.
+        void run(const std::function<void()> &job)
+        {
+            if (job) _jobs.put(job);
+        }
+
+        // Calls fn(0) .. fn(count - 1) on the workers, returning when all
+        // of the calls have finished.
+        void run_all(size_t count, const std::function<void(size_t)> &fn)
+        {
+            semaphore done;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                _jobs.put([&fn, &done, i]()
+                {
+                    fn(i);
+                    done.release();
+                });
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                done.acquire();
+            }
+        }
+    };
+
+    /**
+     * The worker pool shared by the library, with a worker for each core.
+     * It is created the first time it is used, and its workers finish their
+     * queued jobs and are joined when the program exits.
+     */
+    inline worker_pool &shared_worker_pool()
+    {
+        static worker_pool pool(thread::hardware_concurrency());
+        return pool;
+    }
 }
 #endif // sgsdl2_SGSDL2ConcurrencyUtils_h
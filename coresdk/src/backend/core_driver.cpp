@@ -13,10 +13,12 @@
 
 #include "core_driver.h"
 #include "text_driver.h"
+#include "graphics_driver.h"
 #include "logging_driver.h"
 #include "network_driver.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "audio_driver.h"
 #include "web_driver.h"
@@ -31,16 +33,57 @@ namespace splashkit_lib
     void sk_setup_displays();
     void _init_key_maps();
 
+    static bool _sk_done_init = false;
+
+    // When headless, windows and bitmaps are drawn into CPU surfaces with
+    // SDL's software renderer, and no display is connected to
+    static bool _sk_headless = false;
+
+    void sk_set_headless(bool headless)
+    {
+        if ( _sk_done_init )
+        {
+            LOG(WARNING) << "Headless mode must be chosen before SplashKit is started";
+            return;
+        }
+
+        _sk_headless = headless;
+    }
+
+    bool sk_headless()
+    {
+        return _sk_headless;
+    }
+
     void internal_sk_init()
     {
-        static bool done_init = false;
-        if ( done_init ) return;
-        done_init = true;
+        if ( _sk_done_init ) return;
+        _sk_done_init = true;
+
+        // Background png saves must be written, and their workers joined,
+        // before the statics holding them are destroyed
+        atexit(_sk_stop_png_workers);
 
         el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Format, "%datetime %level: %msg");
 
+        // SPLASHKIT_HEADLESS=1 selects headless mode without code changes, e.g. on CI
+        const char *headless_env = getenv("SPLASHKIT_HEADLESS");
+        if ( headless_env && headless_env[0] && strcmp(headless_env, "0") != 0 )
+        {
+            _sk_headless = true;
+        }
+
+        Uint32 subsystems = SDL_INIT_EVERYTHING;
+
+        if ( _sk_headless )
+        {
+            // No video, and a silent audio device when there is no sound card
+            subsystems = SDL_INIT_TIMER | SDL_INIT_AUDIO | SDL_INIT_EVENTS;
+            SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+        }
+
         // LOG(TRACE) << "About to initialise splashkit";
-        if ( -1 == SDL_Init( SDL_INIT_EVERYTHING ) )
+        if ( -1 == SDL_Init( subsystems ) )
         {
             // fatal error so...
             // no other functions can now be called
@@ -141,6 +184,13 @@ namespace splashkit_lib
 
     void sk_setup_displays()
     {
+        if ( _sk_headless )
+        {
+            _sk_system_data.num_displays = 0;
+            _sk_system_data.displays = nullptr;
+            return;
+        }
+
         int num_displays = SDL_GetNumVideoDisplays();
         if (num_displays <= 0) {
             exit(-1);
@@ -52,5 +52,8 @@ namespace splashkit_lib
     sk_system_data *sk_read_system_data();
     
     void internal_sk_init();
+
+    void sk_set_headless(bool headless);
+    bool sk_headless();
 }
 #endif /* defined(sk__CoreDriver) */
@@ -21,9 +21,11 @@
 
 #include "png.h"
 #include <string.h>
+#include <cmath>
 
 #include "core_driver.h"
 #include "graphics_driver.h"
+#include "text_driver.h"
 
 using std::cerr;
 using std::endl;
@@ -34,6 +36,13 @@ namespace splashkit_lib
     SDL_Renderer * _sk_prepared_renderer(sk_drawing_surface* surface, unsigned int idx);
     void _sk_complete_render(sk_drawing_surface* surface, unsigned int idx);
 
+    void _sk_flush_window_geometry(sk_window_be *window_be);
+    void _sk_flush_bitmap_geometry(sk_bitmap_be *bitmap_be);
+    void _sk_flush_bitmaps_geometry();
+    void _sk_discard_geometry(sk_geometry_batch *batch);
+    sk_pixel_shadow *_sk_current_pixel_shadow(sk_drawing_surface *surface);
+    sk_pixel_shadow *_sk_pixel_shadow(sk_drawing_surface *surface, unsigned int &version);
+
 
     static sk_window_be ** _sk_open_windows = nullptr;
     static unsigned int _sk_num_open_windows = 0;
@@ -55,6 +64,9 @@ namespace splashkit_lib
     {
         SDL_Window *window = (SDL_Window *)p;
 
+        // headless windows have no SDL_Window to match
+        if ( ! window ) return nullptr;
+
         for (unsigned int i = 0; i < _sk_num_open_windows; i++)
         {
             if (window == _sk_open_windows[i]->window)
@@ -69,73 +81,238 @@ namespace splashkit_lib
 
     //--------------------------------------------------------------------------------------
     //
-    // Functions to work with renderer targets - switching targets etc
+    // Render state cache
     //
     //--------------------------------------------------------------------------------------
 
-    void _sk_restore_default_render_target(sk_window_be *window_be, sk_bitmap_be *from_bmp)
+    //
+    // Mark all of the window's renderer state as unknown, so that the next
+    // change is always passed on to SDL
+    //
+    void _sk_forget_render_state(sk_window_be *window_be)
     {
-        SDL_SetRenderTarget(window_be->renderer, window_be->backing);
-        SDL_SetRenderDrawBlendMode(window_be->renderer, SDL_BLENDMODE_BLEND);
-        if ( window_be->clipped )
+        window_be->state.target_known = false;
+        window_be->state.target = nullptr;
+        window_be->state.blend = SDL_BLENDMODE_INVALID;
+        window_be->state.color_known = false;
+        window_be->state.clip_known = false;
+        window_be->state.clipped = false;
+    }
+
+    //
+    // The index of the window that owns the renderer, or -1 if it is not
+    // one of the open windows' renderers
+    //
+    int _sk_renderer_window_index(SDL_Renderer *renderer)
+    {
+        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
         {
-            SDL_RenderSetClipRect(window_be->renderer, &window_be->clip);
+            if ( _sk_open_windows[i]->renderer == renderer )
+            {
+                return static_cast<int>(i);
+            }
         }
-        else if ( from_bmp && from_bmp->clipped )
+
+        return -1;
+    }
+
+    sk_render_state *_sk_renderer_state(SDL_Renderer *renderer)
+    {
+        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
         {
-            SDL_RenderSetClipRect(window_be->renderer, nullptr);
+            if ( _sk_open_windows[i]->renderer == renderer )
+            {
+                return &_sk_open_windows[i]->state;
+            }
         }
+
+        return nullptr;
     }
 
-    void _sk_restore_default_render_target(unsigned int window_idx, sk_bitmap_be *from_bmp)
+    void _sk_state_target(sk_window_be *window_be, SDL_Texture *target)
     {
-        _sk_restore_default_render_target(_sk_open_windows[window_idx], from_bmp);
+        sk_render_state &state = window_be->state;
+
+        if ( state.target_known && state.target == target ) return;
+
+        SDL_SetRenderTarget(window_be->renderer, target);
+        state.target_known = true;
+        state.target = target;
+
+        // SDL resets the clip when targeting a texture, and brings back the
+        // window's own clip when targeting the window
+        state.clip_known = target != nullptr;
+        state.clipped = false;
     }
 
-    void _sk_set_renderer_target(unsigned int window_idx, sk_bitmap_be *target)
+    void _sk_state_blend(sk_window_be *window_be, SDL_BlendMode blend)
     {
-        sk_window_be * window_be = _sk_open_windows[window_idx];
-        SDL_SetRenderTarget(window_be->renderer, target->texture[window_idx]);
-        SDL_SetRenderDrawBlendMode(window_be->renderer, SDL_BLENDMODE_BLEND);
+        if ( window_be->state.blend == blend ) return;
+
+        SDL_SetRenderDrawBlendMode(window_be->renderer, blend);
+        window_be->state.blend = blend;
+    }
+
+    void _sk_state_clip(sk_window_be *window_be, const SDL_Rect *clip)
+    {
+        sk_render_state &state = window_be->state;
+
+        if ( state.clip_known )
+        {
+            if ( ! clip && ! state.clipped ) return;
+            if ( clip && state.clipped && SDL_RectEquals(clip, &state.clip) ) return;
+        }
+
+        SDL_RenderSetClipRect(window_be->renderer, clip);
+        state.clip_known = true;
+        state.clipped = clip != nullptr;
+        if ( clip ) state.clip = *clip;
+    }
+
+    void _sk_set_draw_color(SDL_Renderer *renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+    {
+        sk_render_state *state = _sk_renderer_state(renderer);
+
+        if ( state && state->color_known &&
+             state->color.r == r && state->color.g == g && state->color.b == b && state->color.a == a )
+        {
+            return;
+        }
+
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+        if ( state )
+        {
+            state->color_known = true;
+            state->color = { r, g, b, a };
+        }
+    }
+
+    void _sk_set_draw_color(SDL_Renderer *renderer, sk_color clr)
+    {
+        _sk_set_draw_color(renderer,
+                           static_cast<Uint8>(clr.r * 255),
+                           static_cast<Uint8>(clr.g * 255),
+                           static_cast<Uint8>(clr.b * 255),
+                           static_cast<Uint8>(clr.a * 255));
+    }
+
+    //
+    // Destroy a texture made on the window's renderer. SDL switches the
+    // renderer back to the window if the texture was its target.
+    //
+    void _sk_destroy_texture(sk_window_be *window_be, SDL_Texture *tex)
+    {
+        if ( window_be->state.target == tex )
+        {
+            window_be->state.target_known = false;
+        }
+
+        SDL_DestroyTexture(tex);
+    }
+
+    //
+    // SDL_gfx sets the draw color and blend mode itself, so call this after
+    // using it
+    //
+    void _sk_forget_draw_state(SDL_Renderer *renderer)
+    {
+        sk_render_state *state = _sk_renderer_state(renderer);
+
+        if ( state )
+        {
+            state->blend = SDL_BLENDMODE_INVALID;
+            state->color_known = false;
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    //
+    // Functions to work with renderer targets - switching targets etc
+    //
+    //--------------------------------------------------------------------------------------
+
+    //
+    // Target the window's backing texture. Drawing onto a bitmap leaves its
+    // renderer targeting the bitmap, and the switch back is only made here,
+    // once something needs the window again.
+    //
+    void _sk_restore_default_render_target(sk_window_be *window_be)
+    {
+        _sk_state_target(window_be, window_be->backing);
+        _sk_state_blend(window_be, SDL_BLENDMODE_BLEND);
+        _sk_state_clip(window_be, window_be->clipped ? &window_be->clip : nullptr);
+    }
+
+    void _sk_create_initial_window();
 
-        if ( target->clipped )
+    //
+    // Make sure the bitmap's texture is on a window, loading it from the
+    // surface onto the first window if no window holds it yet.
+    //
+    void _sk_ensure_bitmap_owner(sk_bitmap_be *bitmap)
+    {
+        if ( _sk_num_open_windows == 0 ) _sk_create_initial_window();
+        if ( bitmap->owner < _sk_num_open_windows ) return;
+
+        if ( ! bitmap->surface )
         {
-            SDL_RenderSetClipRect(window_be->renderer, &target->clip);
+            // there must be a surface if no window has the texture
+            exit(-1);
         }
-        else if ( window_be->clipped )
+
+        bitmap->owner = 0;
+
+        if ( ! bitmap->texture[0] )
         {
-            SDL_RenderSetClipRect(window_be->renderer, nullptr);
+            bitmap->texture[0] = SDL_CreateTextureFromSurface(_sk_open_windows[0]->renderer, bitmap->surface);
+            bitmap->texture_version[0] = bitmap->version;
         }
     }
 
+    //
+    // Target the bitmap's texture on its owner window
+    //
+    void _sk_set_renderer_target(sk_bitmap_be *target)
+    {
+        _sk_ensure_bitmap_owner(target);
+
+        sk_window_be * window_be = _sk_open_windows[target->owner];
+        _sk_state_target(window_be, target->texture[target->owner]);
+        _sk_state_blend(window_be, SDL_BLENDMODE_BLEND);
+        _sk_state_clip(window_be, target->clipped ? &target->clip : nullptr);
+    }
+
     void _sk_make_drawable(sk_bitmap_be *bitmap)
     {
-        // recreate all textures with target access
+        // recreate the owner's texture with target access -- copies on
+        // other windows are refreshed once they are out of date
 
         int access, w, h;
 
-        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
-        {
-            SDL_Renderer *renderer = _sk_open_windows[i]->renderer;
+        _sk_ensure_bitmap_owner(bitmap);
 
-            SDL_Texture *orig_tex = bitmap->texture[i];
+        unsigned int i = bitmap->owner;
+        SDL_Renderer *renderer = _sk_open_windows[i]->renderer;
 
-            SDL_QueryTexture(orig_tex, nullptr, &access, &w, &h);
+        SDL_Texture *orig_tex = bitmap->texture[i];
 
-            if ( access == SDL_TEXTUREACCESS_TARGET ) continue; // already target
+        SDL_QueryTexture(orig_tex, nullptr, &access, &w, &h);
 
+        if ( access != SDL_TEXTUREACCESS_TARGET )
+        {
             // Create new texture
             SDL_Texture *tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+            SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
             bitmap->texture[i] = tex;
 
             // Draw onto new texture
-            SDL_SetRenderTarget(renderer, tex);
+            _sk_state_target(_sk_open_windows[i], tex);
             SDL_RenderCopy(renderer, orig_tex, nullptr, nullptr);
 
             // Destroy old
             SDL_DestroyTexture(orig_tex);
-
-            _sk_restore_default_render_target(_sk_open_windows[i], bitmap);
         }
 
         // Remove surface
@@ -147,6 +324,18 @@ namespace splashkit_lib
     }
 
 
+    void _sk_init_pixel_shadow(sk_pixel_shadow &shadow)
+    {
+        shadow.pixels = nullptr;
+        shadow.width = 0;
+        shadow.height = 0;
+        shadow.version = UINT_MAX;
+        shadow.locked = false;
+        shadow.reads = 0;
+        shadow.read_version = UINT_MAX;
+    }
+
+
     //--------------------------------------------------------------------------------------
     //
     // Window and Bitmap store functions
@@ -160,6 +349,31 @@ namespace splashkit_lib
 
     //forward declare functions needed for window open
     void _sk_present_window(sk_window_be *window_be);
+    void _sk_add_bitmap_texture_slots();
+
+    //
+    // Headless windows have no SDL_Window. A software renderer draws into a
+    // CPU surface instead, which works without any display.
+    //
+    void _sk_create_headless_renderer(sk_window_be *window_be, int width, int height)
+    {
+        window_be->window = nullptr;
+        window_be->canvas = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888);
+
+        if ( ! window_be->canvas )
+        {
+            cerr << "Splashkit failed to create a headless surface." << endl << SDL_GetError() << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        window_be->renderer = SDL_CreateSoftwareRenderer(window_be->canvas);
+
+        if ( ! window_be->renderer )
+        {
+            cerr << "Splashkit failed to create a headless renderer." << endl << SDL_GetError() << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
 
     // The initial window is a hidden window that is always "open"
     // This allows drawing without the user having to open a window initially.
@@ -174,42 +388,56 @@ namespace splashkit_lib
 
         _sk_has_initial_window = true;
         _sk_initial_window = static_cast<sk_window_be *>(malloc(sizeof(sk_window_be)));
+        _sk_initial_window->canvas = nullptr;
 
-        _sk_initial_window->window = SDL_CreateWindow("SplashKit",
-                                                      SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 200, 200,
-                                                      SDL_WINDOW_ALLOW_HIGHDPI );
-
-        if ( ! _sk_initial_window->window )
+        if ( sk_headless() )
         {
-            cerr << "Splashkit failed to load a window." << endl << SDL_GetError() << endl;;
-            exit(-1);
+            _sk_create_headless_renderer(_sk_initial_window, 200, 200);
         }
+        else
+        {
+            _sk_initial_window->window = SDL_CreateWindow("SplashKit",
+                                                          SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 200, 200,
+                                                          SDL_WINDOW_ALLOW_HIGHDPI );
 
-        _sk_initial_window->renderer = SDL_CreateRenderer(_sk_initial_window->window,
-                                                          -1,
-                                                          SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE );
+            if ( ! _sk_initial_window->window )
+            {
+                cerr << "Splashkit failed to load a window." << endl << SDL_GetError() << endl;;
+                exit(-1);
+            }
 
-        if ( ! _sk_initial_window->renderer )
-        {
-            _sk_initial_window->renderer = SDL_CreateRenderer(_sk_initial_window->window, -1, SDL_RENDERER_TARGETTEXTURE );
+            _sk_initial_window->renderer = SDL_CreateRenderer(_sk_initial_window->window,
+                                                              -1,
+                                                              SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE );
 
             if ( ! _sk_initial_window->renderer )
             {
-                cerr << "Splashkit failed to create a renderer for the window." << endl << (SDL_GetError()) << endl;
-                exit(EXIT_FAILURE);
+                _sk_initial_window->renderer = SDL_CreateRenderer(_sk_initial_window->window, -1, SDL_RENDERER_TARGETTEXTURE );
+
+                if ( ! _sk_initial_window->renderer )
+                {
+                    cerr << "Splashkit failed to create a renderer for the window." << endl << (SDL_GetError()) << endl;
+                    exit(EXIT_FAILURE);
+                }
             }
         }
 
         SDL_SetRenderDrawBlendMode(_sk_initial_window->renderer, SDL_BLENDMODE_BLEND);
         SDL_PumpEvents();
         //HACK: Change size of Mojave
-        SDL_SetWindowSize(_sk_initial_window->window, 200, 200);
+        if ( _sk_initial_window->window ) SDL_SetWindowSize(_sk_initial_window->window, 200, 200);
 
         //    std::cout << "Initial Renderer is " << _sk_initial_window->renderer << std::endl;
 
         // The user cannot draw onto this window!
         _sk_initial_window->backing = SDL_CreateTexture(_sk_initial_window->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 200, 200);
         _sk_initial_window->surface = nullptr;
+        _sk_initial_window->pending = nullptr;
+        _sk_initial_window->version = 0;
+        _sk_initial_window->partial_present = false;
+        _sk_initial_window->dirty = {0,0,0,0};
+        _sk_init_pixel_shadow(_sk_initial_window->shadow);
+        _sk_forget_render_state(_sk_initial_window);
 
         _sk_initial_window->event_data.close_requested = false;
         _sk_initial_window->event_data.has_focus = false;
@@ -236,27 +464,7 @@ namespace splashkit_lib
         SDL_RenderPresent(_sk_initial_window->renderer);
         SDL_PumpEvents();
 
-        SDL_Texture ** textures = nullptr;
-
-        for (uint bmp_idx = 0; bmp_idx < _sk_num_open_bitmaps; bmp_idx++)
-        {
-            sk_bitmap_be *current_bmp = _sk_open_bitmaps[bmp_idx];
-
-            if (current_bmp->surface)
-            {
-                // expand texture array in bitmap
-                textures = (SDL_Texture**)realloc(current_bmp->texture, sizeof(SDL_Texture*) * _sk_num_open_windows);
-                if ( !textures ) exit (-1); // out of memory
-
-                current_bmp->texture = textures;
-                current_bmp->texture[0] = SDL_CreateTextureFromSurface(_sk_initial_window->renderer, current_bmp->surface );
-            }
-            else
-            {
-                // cout << "failed to load bitmap image with new window" << endl;
-                exit(-1);
-            }
-        }
+        _sk_add_bitmap_texture_slots();
 
         //    std::cout << "CREATED INITIAL WINDOW" << std::endl;
         _sk_present_window(_sk_initial_window);
@@ -265,52 +473,121 @@ namespace splashkit_lib
 
     void _sk_get_pixels_from_renderer(SDL_Renderer *renderer, int x, int y, int w, int h, int *pixels);
 
-    SDL_Texture* _sk_copy_texture(SDL_Texture *src_tex, SDL_Renderer *src_renderer, SDL_Renderer *dest_renderer)
+    //
+    // Copy the bitmap's texture from its owner onto the window at dest_window_idx,
+    // reusing any old copy that window already has.
+    //
+    bool _sk_is_target_texture(SDL_Texture *tex)
     {
-        // Read from initial window
-        void *pixels;
-        int w, h;
+        int access;
+        SDL_QueryTexture(tex, nullptr, &access, nullptr, nullptr);
+        return access == SDL_TEXTUREACCESS_TARGET;
+    }
+
+    void _sk_copy_bitmap_texture(sk_bitmap_be *bitmap, unsigned int dest_window_idx)
+    {
+        sk_window_be *src_window = _sk_open_windows[bitmap->owner];
+        SDL_Renderer *dest_renderer = _sk_open_windows[dest_window_idx]->renderer;
+        SDL_Texture *tex = bitmap->texture[dest_window_idx];
+        int w, h, tex_w, tex_h;
 
-        SDL_QueryTexture(src_tex, nullptr, nullptr, &w, &h);
-        pixels = malloc(static_cast<size_t>(4 * w * h));
+        SDL_QueryTexture(bitmap->texture[bitmap->owner], nullptr, nullptr, &w, &h);
 
-        SDL_SetRenderTarget(src_renderer, src_tex);
-        _sk_get_pixels_from_renderer(src_renderer, 0, 0, w, h, (int*)pixels);
-        
-        //SDL_RenderReadPixels(src_renderer, nullptr, SDL_PIXELFORMAT_RGBA8888, pixels, 4 * w);
+        if ( tex )
+        {
+            // Reuse the texture only if it can be drawn onto, as the copy
+            // may become the owner
+            int access;
+            SDL_QueryTexture(tex, nullptr, &access, &tex_w, &tex_h);
+            if ( tex_w != w || tex_h != h || access != SDL_TEXTUREACCESS_TARGET )
+            {
+                _sk_destroy_texture(_sk_open_windows[dest_window_idx], tex);
+                tex = nullptr;
+            }
+        }
 
-        SDL_Texture *tex = SDL_CreateTexture(dest_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
-        SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+        if ( ! tex )
+        {
+            tex = SDL_CreateTexture(dest_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+            SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+        }
+
+        // Read from the owner window
+        int *pixels = static_cast<int *>(malloc(static_cast<size_t>(4 * w * h)));
+
+        _sk_set_renderer_target(bitmap);
+        _sk_get_pixels_from_renderer(src_window->renderer, 0, 0, w, h, pixels);
 
         SDL_UpdateTexture(tex, nullptr, pixels, 4 * w);
         free(pixels);
 
-        // Restore default target
-        SDL_SetRenderTarget(src_renderer, nullptr);
-
-        return tex;
+        bitmap->texture[dest_window_idx] = tex;
+        bitmap->texture_version[dest_window_idx] = bitmap->version;
     }
 
-    void _sk_create_texture_for_bitmap_window(sk_bitmap_be *current_bmp, unsigned int src_window_idx, unsigned int dest_window_idx)
+    //
+    // Get the bitmap's texture for drawing onto the window at window_idx. Other
+    // windows get their copy here, the first time they draw it or once it is out
+    // of date.
+    //
+    SDL_Texture * _sk_bitmap_texture(sk_bitmap_be *bitmap, unsigned int window_idx)
     {
-        sk_window_be *window = _sk_open_windows[dest_window_idx];
+        if ( window_idx >= _sk_num_open_windows ) return nullptr;
+
+        if ( bitmap->owner >= _sk_num_open_windows && bitmap->surface )
+        {
+            // No window has the texture yet, so this one can own it
+            bitmap->owner = window_idx;
+        }
+
+        SDL_Texture *tex = bitmap->texture[window_idx];
+
+        if ( window_idx == bitmap->owner && tex ) return tex;
+        if ( tex && bitmap->texture_version[window_idx] == bitmap->version ) return tex;
 
-        // if the surface exists, use that to create the new bitmap... otherwise extract from texture
-        if (current_bmp->surface && not current_bmp->drawable)
+        // if the surface exists, use that to create the new texture... otherwise copy from the owner
+        if ( bitmap->surface && not bitmap->drawable )
         {
-            current_bmp->texture[dest_window_idx] = SDL_CreateTextureFromSurface(window->renderer, current_bmp->surface );
+            if ( tex ) _sk_destroy_texture(_sk_open_windows[window_idx], tex);
+
+            bitmap->texture[window_idx] = SDL_CreateTextureFromSurface(_sk_open_windows[window_idx]->renderer, bitmap->surface);
+            bitmap->texture_version[window_idx] = bitmap->version;
         }
         else
         {
-            SDL_Texture *src_tex = current_bmp->texture[src_window_idx];
-            current_bmp->texture[dest_window_idx] = _sk_copy_texture(src_tex,
-                                                                     _sk_open_windows[src_window_idx]->renderer, window->renderer);
+            _sk_copy_bitmap_texture(bitmap, window_idx);
+        }
+
+        return bitmap->texture[window_idx];
+    }
+
+    //
+    // Give every bitmap an empty texture slot for the newest window. Textures
+    // for the window are only created when it draws the bitmap.
+    //
+    void _sk_add_bitmap_texture_slots()
+    {
+        for (unsigned int i = 0; i < _sk_num_open_bitmaps; i++)
+        {
+            sk_bitmap_be *current_bmp = _sk_open_bitmaps[i];
+
+            // expand texture arrays in bitmap
+            SDL_Texture ** textures = static_cast<SDL_Texture **>(realloc(current_bmp->texture, sizeof(SDL_Texture*) * _sk_num_open_windows));
+            if ( !textures ) exit (-1); // out of memory
+            current_bmp->texture = textures;
+
+            unsigned int * versions = static_cast<unsigned int *>(realloc(current_bmp->texture_version, sizeof(unsigned int) * _sk_num_open_windows));
+            if ( !versions ) exit (-1); // out of memory
+            current_bmp->texture_version = versions;
+
+            current_bmp->texture[_sk_num_open_windows - 1] = nullptr;
+            current_bmp->texture_version[_sk_num_open_windows - 1] = 0;
         }
     }
 
     //
-    // Add a window to the array of windows, and update all textures so
-    // they can be drawn to this window
+    // Add a window to the array of windows, and make room for the
+    // bitmap textures it will use
     //
     void _sk_add_window(sk_window_be * window)
     {
@@ -330,36 +607,21 @@ namespace splashkit_lib
         windows[idx] = window;
         window->idx = idx;
 
-        // create textures for new window
-
-        SDL_Texture ** textures = nullptr;
-        sk_bitmap_be *current_bmp;
-
-        for (unsigned int i = 0; i < _sk_num_open_bitmaps; i++)
-        {
-            current_bmp = _sk_open_bitmaps[i];
-
-            // expand texture array in bitmap
-            textures = static_cast<SDL_Texture **>(realloc(current_bmp->texture, sizeof(SDL_Texture*) * _sk_num_open_windows));
-            if ( !textures ) exit (-1); // out of memory
-
-            current_bmp->texture = textures;
+        _sk_add_bitmap_texture_slots();
+    }
 
-            if ( idx > 0 ) // this is not the first window open
-                _sk_create_texture_for_bitmap_window(current_bmp, 0, idx);
-            else // first window... copy surface
-            {
-                current_bmp->texture[0] = SDL_CreateTextureFromSurface(window->renderer, current_bmp->surface );
-                //TODO: Could the surface be nullptr here?
-            }
-        }
+    // True if the bitmap's pixels are only in a texture -- it has no
+    // surface, or it has been drawn onto since it was loaded
+    bool _sk_bitmap_needs_surface(sk_bitmap_be *bmp)
+    {
+        return ! bmp->surface || ( bmp->drawable && bmp->owner != UINT_MAX );
     }
 
-    bool _sk_has_open_bitmap_without_surface()
+    bool _sk_has_open_bitmap_needing_surface()
     {
         for (uint i = 0; i < _sk_num_open_bitmaps; i++)
         {
-            if ( ! _sk_open_bitmaps[i]->surface ) return true;
+            if ( _sk_bitmap_needs_surface(_sk_open_bitmaps[i]) ) return true;
         }
 
         return false;
@@ -369,29 +631,31 @@ namespace splashkit_lib
     {
         SDL_Rect rect = {x, y, w, h};
 
-        int *raw_pixels = (int*)malloc( sizeof(int) * static_cast<unsigned long>(w * h) );
-        SDL_RenderReadPixels(renderer, &rect, SDL_PIXELFORMAT_RGBA8888, raw_pixels, w * 4);
+        // read straight into the destination
+        SDL_RenderReadPixels(renderer, &rect, SDL_PIXELFORMAT_RGBA8888, pixels, w * 4);
 
-        for (int row = 0; row < h; row++)
-        {
-            // Copy a row from the paw pixels to the dest pixels
 #ifdef WINDOWS
-            memcpy(&pixels[(h - row - 1) * w], &raw_pixels[row *  w], sizeof(int) * static_cast<unsigned long>(w));
-#else
-            memcpy(&pixels[row * w], &raw_pixels[row *  w], sizeof(int) * static_cast<unsigned long>(w));
-#endif
+        // Texture is inverted so flip the rows
+        int *row_pixels = (int*)malloc( sizeof(int) * static_cast<unsigned long>(w) );
+        size_t row_sz = sizeof(int) * static_cast<unsigned long>(w);
+
+        for (int row = 0; row < h / 2; row++)
+        {
+            memcpy(row_pixels, &pixels[row * w], row_sz);
+            memcpy(&pixels[row * w], &pixels[(h - row - 1) * w], row_sz);
+            memcpy(&pixels[(h - row - 1) * w], row_pixels, row_sz);
         }
-        free(raw_pixels);
+        free(row_pixels);
+#endif
     }
 
     void _sk_bitmap_be_texture_to_pixels(sk_bitmap_be *bitmap_be, int *pixels, int sz, int w, int h)
     {
         if (bitmap_be->drawable && _sk_num_open_windows > 0)
         {
-            // read pixels from the texture
-            _sk_set_renderer_target(0, bitmap_be);
-            _sk_get_pixels_from_renderer(_sk_open_windows[0]->renderer, 0, 0, w, h, pixels);
-            _sk_restore_default_render_target(_sk_open_windows[0], bitmap_be);
+            // read pixels from the owner's texture
+            _sk_set_renderer_target(bitmap_be);
+            _sk_get_pixels_from_renderer(_sk_open_windows[bitmap_be->owner]->renderer, 0, 0, w, h, pixels);
         }
         else
         {
@@ -406,6 +670,8 @@ namespace splashkit_lib
     {
         Uint32 rmask, gmask, bmask, amask;
 
+        _sk_flush_bitmaps_geometry();
+
         /* SDL interprets each pixel as a 32-bit number, so our masks must depend
          on the endianness (byte order) of the machine */
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
@@ -422,10 +688,10 @@ namespace splashkit_lib
 
         for (uint i = 0; i < _sk_num_open_bitmaps; i++)
         {
-            if ( ! _sk_open_bitmaps[i]->surface )
+            if ( _sk_bitmap_needs_surface(_sk_open_bitmaps[i]) )
             {
                 int w, h;
-                SDL_QueryTexture(_sk_open_bitmaps[i]->texture[0], nullptr, nullptr, &w, &h);
+                SDL_QueryTexture(_sk_open_bitmaps[i]->texture[_sk_open_bitmaps[i]->owner], nullptr, nullptr, &w, &h);
 
                 int sz = 4 * w * h;
                 int pixels[w * h];
@@ -436,6 +702,9 @@ namespace splashkit_lib
 
                 _sk_bitmap_be_texture_to_pixels(_sk_open_bitmaps[i], pixels, sz, w, h);
 
+                // a loaded bitmap that has been drawn onto replaces its stale surface
+                if ( _sk_open_bitmaps[i]->surface ) SDL_FreeSurface(_sk_open_bitmaps[i]->surface);
+
                 _sk_open_bitmaps[i]->surface = SDL_CreateRGBSurface(0, w, h, 32, rmask, gmask, bmask, amask);
 
                 SDL_LockSurface(_sk_open_bitmaps[i]->surface);
@@ -463,6 +732,44 @@ namespace splashkit_lib
         }
     }
 
+    //
+    // The bitmap's owner window is closing, so move the bitmap to another
+    // window, or back to its surface if there are no other windows.
+    //
+    void _sk_move_bitmap_owner(sk_bitmap_be *bmp)
+    {
+        unsigned int from = bmp->owner;
+
+        // Prefer a window that already has an up to date copy, that can be
+        // drawn onto if the bitmap is drawable
+        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
+        {
+            if ( i != from && bmp->texture[i] && bmp->texture_version[i] == bmp->version &&
+                 ( not bmp->drawable || _sk_is_target_texture(bmp->texture[i]) ) )
+            {
+                bmp->owner = i;
+                return;
+            }
+        }
+
+        if ( bmp->surface && not bmp->drawable )
+        {
+            // Can be loaded again from the surface when needed
+            bmp->owner = UINT_MAX;
+        }
+        else if ( _sk_num_open_windows > 1 )
+        {
+            unsigned int to = from == 0 ? 1 : 0;
+            _sk_copy_bitmap_texture(bmp, to);
+            bmp->owner = to;
+        }
+        else
+        {
+            // last window - pixels have already been saved to the surface
+            bmp->owner = UINT_MAX;
+        }
+    }
+
     void _sk_remove_window(sk_window_be * window_be)
     {
         unsigned int idx = window_be->idx;
@@ -472,26 +779,42 @@ namespace splashkit_lib
             exit(-1);
         }
 
-        if ( _sk_num_open_windows == 1 && _sk_has_open_bitmap_without_surface() )
+        if ( _sk_num_open_windows == 1 && _sk_has_open_bitmap_needing_surface() )
         {
             // Need to keep a window open to retain the bitmap surface
             _sk_restore_surfaces();
         }
 
         // Remove all of the textures for this window
+        _sk_remove_text_textures(idx);
+
         for (unsigned int bmp_idx = 0; bmp_idx < _sk_num_open_bitmaps; bmp_idx++)
         {
+            sk_bitmap_be *bmp = _sk_open_bitmaps[bmp_idx];
+
+            if ( bmp->owner == idx )
+            {
+                _sk_move_bitmap_owner(bmp);
+            }
+
             // Delete the relevant texture
-            SDL_DestroyTexture(_sk_open_bitmaps[bmp_idx]->texture[idx]);
+            if ( bmp->texture[idx] ) SDL_DestroyTexture(bmp->texture[idx]);
 
             // shuffle left from idx
             for (unsigned int i = idx; i < _sk_num_open_windows - 1; i++)
             {
-                _sk_open_bitmaps[bmp_idx]->texture[i] = _sk_open_bitmaps[bmp_idx]->texture[i + 1];
+                bmp->texture[i] = bmp->texture[i + 1];
+                bmp->texture_version[i] = bmp->texture_version[i + 1];
             }
 
-            // Change size of array
-            _sk_open_bitmaps[bmp_idx]->texture = static_cast<SDL_Texture **>(realloc(_sk_open_bitmaps[bmp_idx]->texture, sizeof(sk_bitmap_be *) * _sk_num_open_windows - 1));
+            if ( bmp->owner != UINT_MAX && bmp->owner > idx ) bmp->owner--;
+
+            // Change size of arrays
+            if ( _sk_num_open_windows > 1 )
+            {
+                bmp->texture = static_cast<SDL_Texture **>(realloc(bmp->texture, sizeof(SDL_Texture *) * (_sk_num_open_windows - 1)));
+                bmp->texture_version = static_cast<unsigned int *>(realloc(bmp->texture_version, sizeof(unsigned int) * (_sk_num_open_windows - 1)));
+            }
         }
 
         // Shuffle all windows left from idx
@@ -537,11 +860,18 @@ namespace splashkit_lib
         }
 
         SDL_DestroyRenderer(window_be->renderer);
-        SDL_DestroyWindow(window_be->window);
+        if ( window_be->window ) SDL_DestroyWindow(window_be->window);
+        if ( window_be->canvas ) SDL_FreeSurface(window_be->canvas);
+
+        delete window_be->pending;
+        window_be->pending = nullptr;
+        free(window_be->shadow.pixels);
+        window_be->shadow.pixels = nullptr;
 
         window_be->idx = UINT_MAX;
         window_be->renderer = nullptr;
         window_be->window = nullptr;
+        window_be->canvas = nullptr;
         window_be->backing = nullptr;
 
         if ( _sk_initial_window == window_be )
@@ -634,10 +964,11 @@ namespace splashkit_lib
 
         for (unsigned int bmp_idx = 0; bmp_idx < _sk_num_open_windows; bmp_idx++)
         {
-            SDL_DestroyTexture(bitmap_be->texture[bmp_idx]);
+            if ( bitmap_be->texture[bmp_idx] ) _sk_destroy_texture(_sk_open_windows[bmp_idx], bitmap_be->texture[bmp_idx]);
             bitmap_be->texture[bmp_idx] = nullptr;
         }
         free(bitmap_be->texture);
+        free(bitmap_be->texture_version);
 
         if (bitmap_be->surface)
         {
@@ -646,6 +977,12 @@ namespace splashkit_lib
 
         bitmap_be->surface = nullptr;
         bitmap_be->texture = nullptr;
+        bitmap_be->texture_version = nullptr;
+
+        delete bitmap_be->pending;
+        bitmap_be->pending = nullptr;
+        free(bitmap_be->shadow.pixels);
+        bitmap_be->shadow.pixels = nullptr;
 
         free(bitmap_be);
     }
@@ -659,38 +996,47 @@ namespace splashkit_lib
 
     bool _sk_open_window(const char *title, int width, int height, unsigned int options, sk_window_be *window_be)
     {
-        window_be->window = SDL_CreateWindow(title,
-                                             SDL_WINDOWPOS_CENTERED,
-                                             SDL_WINDOWPOS_CENTERED,
-                                             width,
-                                             height,
-                                             options | SDL_WINDOW_ALLOW_HIGHDPI | SDL_WINDOW_INPUT_FOCUS);
+        window_be->canvas = nullptr;
 
-        if ( ! window_be->window )
+        if ( sk_headless() )
         {
-            cerr << "Splashkit failed to open a window." << endl << (SDL_GetError()) << endl;
-            exit(EXIT_FAILURE);
+            _sk_create_headless_renderer(window_be, width, height);
         }
+        else
+        {
+            window_be->window = SDL_CreateWindow(title,
+                                                 SDL_WINDOWPOS_CENTERED,
+                                                 SDL_WINDOWPOS_CENTERED,
+                                                 width,
+                                                 height,
+                                                 options | SDL_WINDOW_ALLOW_HIGHDPI | SDL_WINDOW_INPUT_FOCUS);
 
-        // Setup the fullscreen mode
-        SDL_DisplayMode fullscreen_mode;
-        SDL_zero(fullscreen_mode);
-        fullscreen_mode.format = SDL_PIXELFORMAT_RGB888;
-        SDL_SetWindowDisplayMode(window_be->window, &fullscreen_mode);
+            if ( ! window_be->window )
+            {
+                cerr << "Splashkit failed to open a window." << endl << (SDL_GetError()) << endl;
+                exit(EXIT_FAILURE);
+            }
 
-        // Create the actual renderer -- accellerated,
-        window_be->renderer = SDL_CreateRenderer(window_be->window,
-                                                 -1,
-                                                 SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE );
+            // Setup the fullscreen mode
+            SDL_DisplayMode fullscreen_mode;
+            SDL_zero(fullscreen_mode);
+            fullscreen_mode.format = SDL_PIXELFORMAT_RGB888;
+            SDL_SetWindowDisplayMode(window_be->window, &fullscreen_mode);
 
-        if ( ! window_be->renderer )
-        {
-            window_be->renderer = SDL_CreateRenderer(window_be->window, -1, SDL_RENDERER_TARGETTEXTURE );
+            // Create the actual renderer -- accellerated,
+            window_be->renderer = SDL_CreateRenderer(window_be->window,
+                                                     -1,
+                                                     SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE );
 
             if ( ! window_be->renderer )
             {
-                cerr << "Splashkit failed to create a renderer for the window." << endl << (SDL_GetError()) << endl;
-                exit(EXIT_FAILURE);
+                window_be->renderer = SDL_CreateRenderer(window_be->window, -1, SDL_RENDERER_TARGETTEXTURE );
+
+                if ( ! window_be->renderer )
+                {
+                    cerr << "Splashkit failed to create a renderer for the window." << endl << (SDL_GetError()) << endl;
+                    exit(EXIT_FAILURE);
+                }
             }
         }
 
@@ -707,6 +1053,7 @@ namespace splashkit_lib
         SDL_SetRenderDrawBlendMode(window_be->renderer, SDL_BLENDMODE_BLEND);
         SDL_RenderClear(window_be->renderer);
 
+        _sk_forget_render_state(window_be);
         _sk_add_window(window_be);
         
         if( _sk_has_initial_window )
@@ -714,11 +1061,11 @@ namespace splashkit_lib
             _sk_destroy_initial_window();
         }
 
-        SDL_RaiseWindow(window_be->window);
+        if ( window_be->window ) SDL_RaiseWindow(window_be->window);
         _sk_present_window(window_be);
         SDL_PumpEvents();
         //HACK: Change size of Mojave
-        SDL_SetWindowSize(window_be->window, width, height);
+        if ( window_be->window ) SDL_SetWindowSize(window_be->window, width, height);
 
         return true;
     }
@@ -741,6 +1088,14 @@ namespace splashkit_lib
             exit(EXIT_FAILURE);
         }
 
+        window_be->pending = nullptr;
+        window_be->version = 0;
+        _sk_init_pixel_shadow(window_be->shadow);
+        window_be->partial_present = false;
+        window_be->dirty = {0,0,0,0};
+        window_be->clipped = false;
+        window_be->clip = {0,0,0,0};
+
         if ( ! _sk_open_window(title, width, height, SDL_WINDOW_SHOWN, window_be) )
         {
             free ( window_be );
@@ -749,9 +1104,6 @@ namespace splashkit_lib
 
         result._data = window_be;
 
-        window_be->clipped = false;
-        window_be->clip = {0,0,0,0};
-
         window_be->event_data.close_requested = false;
         window_be->event_data.has_focus = false;
         window_be->event_data.mouse_over = false;
@@ -803,17 +1155,13 @@ namespace splashkit_lib
         sk_window_be *wind = static_cast<sk_window_be *>(surface->_data);
         sk_bitmap_be *bmp = static_cast<sk_bitmap_be *>(icon->_data);
 
-        SDL_SetWindowIcon(wind->window, bmp->surface);
+        if ( wind->window ) SDL_SetWindowIcon(wind->window, bmp->surface);
     }
 
 
     void _sk_do_clear(SDL_Renderer *renderer, sk_color clr)
     {
-        SDL_SetRenderDrawColor(renderer,
-                               static_cast<Uint8>(clr.r * 255),
-                               static_cast<Uint8>(clr.g * 255),
-                               static_cast<Uint8>(clr.b * 255),
-                               static_cast<Uint8>(clr.a * 255));
+        _sk_set_draw_color(renderer, clr);
         SDL_RenderClear(renderer);
     }
 
@@ -824,7 +1172,13 @@ namespace splashkit_lib
 
         if ( window_be )
         {
+            // Clearing ignores the clip rect, so anything queued would be wiped anyway
+            _sk_discard_geometry(window_be->pending);
+
+            _sk_restore_default_render_target(window_be);
             _sk_do_clear(window_be->renderer, clr);
+            window_be->version++;
+            _sk_mark_window_dirty(window_be);
 
             //ATI cards are lazy, won't draw the clear screen until you actually draw something else on top of it
             SDL_Rect rect = { 0, 0, 1, 1 };
@@ -840,17 +1194,15 @@ namespace splashkit_lib
         {
             if ( ! bitmap_be->drawable ) _sk_make_drawable( bitmap_be );
 
-            for (unsigned int i = 0; i < _sk_num_open_windows; i++)
-            {
-                sk_window_be *window = _sk_open_windows[i];
-                SDL_Renderer *renderer = window->renderer;
+            _sk_discard_geometry(bitmap_be->pending);
 
-                _sk_set_renderer_target(i, bitmap_be);
+            sk_window_be *window = _sk_open_windows[bitmap_be->owner];
 
-                _sk_do_clear(renderer, clr);
+            _sk_set_renderer_target(bitmap_be);
 
-                _sk_restore_default_render_target(window, bitmap_be);
-            }
+            _sk_do_clear(window->renderer, clr);
+
+            bitmap_be->version++;
         }
     }
 
@@ -873,15 +1225,132 @@ namespace splashkit_lib
         }
     }
 
-    void _sk_present_window(sk_window_be *window_be)
-    {
-        if ( window_be && window_be->backing )
-        {
-            SDL_SetRenderTarget(window_be->renderer, nullptr);
-
+    //--------------------------------------------------------------------------------------
+    //
+    // Dirty regions
+    //
+    //--------------------------------------------------------------------------------------
+
+    //
+    // Windows using partial presents track the area drawn onto since their
+    // last present. Other windows and bitmaps are not tracked.
+    //
+
+    void _sk_add_dirty_rect(sk_window_be *window_be, const SDL_Rect &rect)
+    {
+        if ( ! window_be->partial_present || SDL_RectEmpty(&rect) ) return;
+
+        if ( SDL_RectEmpty(&window_be->dirty) )
+            window_be->dirty = rect;
+        else
+            SDL_UnionRect(&window_be->dirty, &rect, &window_be->dirty);
+    }
+
+    //
+    // The whole window must be presented, e.g. after it was uncovered
+    //
+    void _sk_mark_window_dirty(sk_window_be *window_be)
+    {
+        int w, h;
+
+        if ( ! window_be || ! window_be->backing ) return;
+
+        SDL_QueryTexture(window_be->backing, nullptr, nullptr, &w, &h);
+
+        SDL_Rect all = { 0, 0, w, h };
+        window_be->dirty = all;
+    }
+
+    //
+    // Mark the box around the points as drawn. pts holds count x,y pairs,
+    // and pad is added to all sides for line widths.
+    //
+    void _sk_mark_dirty_points(sk_drawing_surface *surface, const double *pts, int count, double pad)
+    {
+        if ( surface->kind != SGDS_Window || count < 1 ) return;
+
+        sk_window_be *window_be = static_cast<sk_window_be *>(surface->_data);
+
+        if ( ! window_be || ! window_be->partial_present ) return;
+
+        double min_x = pts[0], max_x = pts[0];
+        double min_y = pts[1], max_y = pts[1];
+
+        for (int i = 1; i < count; i++)
+        {
+            min_x = fmin(min_x, pts[i * 2]);
+            max_x = fmax(max_x, pts[i * 2]);
+            min_y = fmin(min_y, pts[i * 2 + 1]);
+            max_y = fmax(max_y, pts[i * 2 + 1]);
+        }
+
+        // An extra pixel each side covers rounding and antialiasing
+        int left = static_cast<int>(floor(min_x - pad)) - 1;
+        int top = static_cast<int>(floor(min_y - pad)) - 1;
+        int right = static_cast<int>(ceil(max_x + pad)) + 1;
+        int bottom = static_cast<int>(ceil(max_y + pad)) + 1;
+
+        SDL_Rect rect = { left, top, right - left + 1, bottom - top + 1 };
+        _sk_add_dirty_rect(window_be, rect);
+    }
+
+    void _sk_mark_dirty(sk_drawing_surface *surface, double x, double y, double width, double height)
+    {
+        double pts[4] = { x, y, x + width, y + height };
+        _sk_mark_dirty_points(surface, pts, 2, 0);
+    }
+
+    void sk_set_partial_present(sk_drawing_surface *window, bool partial)
+    {
+        if ( ! window || window->kind != SGDS_Window || ! window->_data ) return;
+
+        sk_window_be *window_be = static_cast<sk_window_be *>(window->_data);
+
+        window_be->partial_present = partial;
+        _sk_mark_window_dirty(window_be);
+    }
+
+    bool sk_partial_present(sk_drawing_surface *window)
+    {
+        if ( ! window || window->kind != SGDS_Window || ! window->_data ) return false;
+
+        return static_cast<sk_window_be *>(window->_data)->partial_present;
+    }
+
+    //
+    // Present the window only if something was drawn since the last present.
+    // The back buffer's contents are undefined after a present, so the whole
+    // window is always copied to it.
+    //
+    void _sk_present_dirty_area(sk_window_be *window_be)
+    {
+        if ( SDL_RectEmpty(&window_be->dirty) ) return;
+
+        _sk_state_target(window_be, nullptr);
+
+        SDL_RenderCopy(window_be->renderer, window_be->backing, nullptr, nullptr);
+        SDL_RenderPresent(window_be->renderer);
+
+        window_be->dirty = { 0, 0, 0, 0 };
+    }
+
+    void _sk_present_window(sk_window_be *window_be)
+    {
+        if ( window_be && window_be->backing )
+        {
+            _sk_flush_window_geometry(window_be);
+
+            if ( window_be->partial_present )
+            {
+                _sk_present_dirty_area(window_be);
+                return;
+            }
+
+            // Left targeting the window until it is next drawn onto
+            _sk_state_target(window_be, nullptr);
+
             SDL_RenderCopy(window_be->renderer, window_be->backing, nullptr, nullptr);
             SDL_RenderPresent(window_be->renderer);
-            _sk_restore_default_render_target(window_be, nullptr);
         }
     }
 
@@ -899,22 +1368,38 @@ namespace splashkit_lib
     // Renderer functions - switch between bmp and window
     //
 
+    SDL_Renderer * _sk_bitmap_renderer(sk_bitmap_be *bitmap_be)
+    {
+        if ( ! bitmap_be->drawable ) _sk_make_drawable( bitmap_be );
+        _sk_set_renderer_target(bitmap_be);
+
+        return _sk_open_windows[bitmap_be->owner]->renderer;
+    }
+
+    //
+    // Get the renderer to draw onto the surface. Bitmaps are only drawn
+    // once, onto their owner window's texture, so idx is always 0 for them.
+    //
     SDL_Renderer * _sk_prepared_renderer(sk_drawing_surface *surface, unsigned int idx)
     {
         switch (surface->kind)
         {
             case SGDS_Window:
-                return static_cast<sk_window_be *>(surface->_data)->renderer;
+            {
+                sk_window_be *window_be = static_cast<sk_window_be *>(surface->_data);
+                _sk_restore_default_render_target(window_be);
+                window_be->version++;
+                return window_be->renderer;
+            }
 
             case SGDS_Bitmap:
             {
                 sk_bitmap_be *bitmap_be = static_cast<sk_bitmap_be *>(surface->_data);
-                if ( ! bitmap_be->drawable ) _sk_make_drawable( bitmap_be );
-                _sk_set_renderer_target(idx, bitmap_be);
 
-                if (idx < _sk_num_open_windows)
-                    return _sk_open_windows[idx]->renderer;
-                else return nullptr;
+                // Copies on other windows are now out of date
+                bitmap_be->version++;
+
+                return _sk_bitmap_renderer(bitmap_be);
             }
 
             case SGDS_Unknown:
@@ -923,38 +1408,344 @@ namespace splashkit_lib
         }
     }
 
+    //
+    // Nothing to undo after drawing -- a renderer left targeting a bitmap is
+    // switched back by _sk_prepared_renderer when its window is drawn onto.
+    //
     void _sk_complete_render(sk_drawing_surface *surface, unsigned int idx)
     {
+    }
+
+    unsigned int _sk_renderer_count(sk_drawing_surface *surface)
+    {
+        // Every immediate draw starts here, so make sure it can not
+        // overtake any geometry still queued for this surface
+        sk_flush_drawing_surface(surface);
+
         switch (surface->kind)
         {
             case SGDS_Window:
+                return 1;
+            case SGDS_Bitmap:
+                // Drawing to a bitmap... so ensure that there is at least one window
+                if ( _sk_num_open_windows == 0 ) _sk_create_initial_window();
+                return 1;
+            case SGDS_Unknown:
+            default:
+                return 0;
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    //
+    // Deferred drawing
+    //
+    //--------------------------------------------------------------------------------------
+
+    //
+    // When deferred, filled shapes, pixels and lines are tessellated into
+    // a geometry batch on the destination surface rather than drawn. The
+    // batch is drawn when the surface is next used by anything else (an
+    // immediate draw, a read, a clip change, drawing it as a bitmap, or
+    // refreshing the window), so drawing order on each surface is kept.
+    //
+    // All of these shapes are drawn with SDL_BLENDMODE_BLEND, the default
+    // state for every target, so one batch per surface is all that is needed.
+    //
+    static bool _sk_deferred = false;
+
+    void sk_set_deferred_drawing(bool deferred)
+    {
+        if ( _sk_deferred && ! deferred ) sk_flush_all_drawing();
+
+        _sk_deferred = deferred;
+    }
+
+    bool sk_deferred_drawing()
+    {
+        return _sk_deferred;
+    }
+
+    sk_geometry_batch *_sk_pending_geometry(sk_drawing_surface *surface)
+    {
+        sk_geometry_batch **pending;
+
+        if ( ! surface->_data ) return nullptr;
+
+        switch (surface->kind)
+        {
+            case SGDS_Window:
+                pending = &static_cast<sk_window_be *>(surface->_data)->pending;
                 break;
+
             case SGDS_Bitmap:
-                if (idx < _sk_num_open_windows)
-                    _sk_restore_default_render_target(_sk_open_windows[idx], static_cast<sk_bitmap_be *>(surface->_data));
+                pending = &static_cast<sk_bitmap_be *>(surface->_data)->pending;
                 break;
+
             case SGDS_Unknown:
             default:
-                break;
+                return nullptr;
         }
+
+        if ( ! *pending ) *pending = new sk_geometry_batch();
+        return *pending;
     }
 
-    unsigned int _sk_renderer_count(sk_drawing_surface *surface)
+    //
+    // Queue a convex polygon, with its points in order around the edge.
+    // This is added as a triangle fan from the first point.
+    //
+    void _sk_queue_polygon(sk_drawing_surface *surface, sk_color clr, const SDL_FPoint *pts, int count)
+    {
+        sk_geometry_batch *batch = _sk_pending_geometry(surface);
+
+        if ( ! batch || count < 3 ) return;
+
+        SDL_Color vertex_clr = {
+            static_cast<Uint8>(clr.r * 255),
+            static_cast<Uint8>(clr.g * 255),
+            static_cast<Uint8>(clr.b * 255),
+            static_cast<Uint8>(clr.a * 255)
+        };
+
+        int first = static_cast<int>(batch->vertices.size());
+
+        for (int i = 0; i < count; i++)
+        {
+            batch->vertices.push_back({ pts[i], vertex_clr, { 0, 0 } });
+        }
+
+        for (int i = 1; i < count - 1; i++)
+        {
+            batch->indices.push_back(first);
+            batch->indices.push_back(first + i);
+            batch->indices.push_back(first + i + 1);
+        }
+    }
+
+    void _sk_queue_rect(sk_drawing_surface *surface, sk_color clr, float x, float y, float w, float h)
+    {
+        if ( w <= 0 || h <= 0 ) return;
+
+        SDL_FPoint pts[4] = { { x, y }, { x + w, y }, { x + w, y + h }, { x, y + h } };
+        _sk_queue_polygon(surface, clr, pts, 4);
+    }
+
+    void _sk_queue_line(sk_drawing_surface *surface, sk_color clr, float x1, float y1, float x2, float y2, float width)
+    {
+        float dx = x2 - x1, dy = y2 - y1;
+        float len = sqrtf(dx * dx + dy * dy);
+
+        if ( len == 0 )
+        {
+            _sk_queue_rect(surface, clr, x1, y1, width, width);
+            return;
+        }
+
+        // Offset the line by half its width each side, and run it through the pixel centres
+        float ox = -dy / len * width / 2.0f, oy = dx / len * width / 2.0f;
+        x1 += 0.5f; y1 += 0.5f; x2 += 0.5f; y2 += 0.5f;
+
+        SDL_FPoint pts[4] = { { x1 + ox, y1 + oy }, { x2 + ox, y2 + oy }, { x2 - ox, y2 - oy }, { x1 - ox, y1 - oy } };
+        _sk_queue_polygon(surface, clr, pts, 4);
+    }
+
+    void _sk_queue_ellipse(sk_drawing_surface *surface, sk_color clr, float cx, float cy, float rx, float ry)
+    {
+        if ( rx <= 0 || ry <= 0 ) return;
+
+        // Aim for edges of around 4 pixels, within sensible limits
+        int count = static_cast<int>(2 * M_PI * fmaxf(rx, ry) / 4);
+        if ( count < 12 ) count = 12;
+        if ( count > 256 ) count = 256;
+
+        SDL_FPoint pts[256];
+
+        for (int i = 0; i < count; i++)
+        {
+            double angle = 2 * M_PI * i / count;
+            pts[i] = { static_cast<float>(cx + rx * cos(angle)), static_cast<float>(cy + ry * sin(angle)) };
+        }
+
+        _sk_queue_polygon(surface, clr, pts, count);
+    }
+
+    void _sk_discard_geometry(sk_geometry_batch *batch)
+    {
+        if ( ! batch ) return;
+
+        // Keep the capacity for the next frame
+        batch->vertices.clear();
+        batch->indices.clear();
+    }
+
+    void _sk_draw_geometry(SDL_Renderer *renderer, sk_geometry_batch *batch)
+    {
+        SDL_RenderGeometry(renderer,
+                           nullptr,
+                           batch->vertices.data(),
+                           static_cast<int>(batch->vertices.size()),
+                           batch->indices.data(),
+                           static_cast<int>(batch->indices.size()));
+    }
+
+    void _sk_flush_window_geometry(sk_window_be *window_be)
     {
+        sk_geometry_batch *batch = window_be->pending;
+
+        if ( ! batch || batch->indices.empty() ) return;
+
+        _sk_restore_default_render_target(window_be);
+        _sk_draw_geometry(window_be->renderer, batch);
+        window_be->version++;
+        _sk_discard_geometry(batch);
+    }
+
+    void _sk_flush_bitmap_geometry(sk_bitmap_be *bitmap_be)
+    {
+        sk_geometry_batch *batch = bitmap_be->pending;
+
+        if ( ! batch || batch->indices.empty() ) return;
+
+        _sk_draw_geometry(_sk_bitmap_renderer(bitmap_be), batch);
+        bitmap_be->version++;
+
+        _sk_discard_geometry(batch);
+    }
+
+    void _sk_flush_bitmaps_geometry()
+    {
+        for (unsigned int i = 0; i < _sk_num_open_bitmaps; i++)
+        {
+            _sk_flush_bitmap_geometry(_sk_open_bitmaps[i]);
+        }
+    }
+
+    void sk_flush_drawing_surface(sk_drawing_surface *surface)
+    {
+        if ( ! surface || ! surface->_data ) return;
+
         switch (surface->kind)
         {
             case SGDS_Window:
-                return 1;
+                _sk_flush_window_geometry(static_cast<sk_window_be *>(surface->_data));
+                break;
+
             case SGDS_Bitmap:
-                // Drawing to a bitmap... so ensure that there is at least one window
-                if ( _sk_num_open_windows == 0 ) _sk_create_initial_window();
-                return _sk_num_open_windows;
+                _sk_flush_bitmap_geometry(static_cast<sk_bitmap_be *>(surface->_data));
+                break;
+
             case SGDS_Unknown:
-            default:
-                return 0;
+                break;
         }
     }
 
+    void sk_flush_all_drawing()
+    {
+        _sk_flush_bitmaps_geometry();
+
+        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
+        {
+            _sk_flush_window_geometry(_sk_open_windows[i]);
+        }
+    }
+
+
+    //
+    // Instanced shapes: a whole array of shapes is tessellated into the
+    // surface's geometry batch, then drawn with a single call (or left
+    // pending when drawing is deferred).
+    //
+
+    struct _sk_bounds
+    {
+        double min_x, min_y, max_x, max_y;
+    };
+
+    static void _sk_grow_bounds(_sk_bounds &b, double x1, double y1, double x2, double y2)
+    {
+        b.min_x = fmin(b.min_x, fmin(x1, x2));
+        b.min_y = fmin(b.min_y, fmin(y1, y2));
+        b.max_x = fmax(b.max_x, fmax(x1, x2));
+        b.max_y = fmax(b.max_y, fmax(y1, y2));
+    }
+
+    static void _sk_submit_instanced(sk_drawing_surface *surface, const _sk_bounds &b)
+    {
+        if ( b.max_x < b.min_x ) return;
+
+        _sk_mark_dirty(surface, b.min_x, b.min_y, b.max_x - b.min_x, b.max_y - b.min_y);
+
+        if ( ! _sk_deferred ) sk_flush_drawing_surface(surface);
+    }
+
+    // 4 values per rectangle = x, y, width, height
+    void sk_fill_rects(sk_drawing_surface *surface, const sk_color *clrs, const double *data, int count)
+    {
+        if ( ! surface || ! surface->_data || ! clrs || ! data ) return;
+
+        _sk_bounds bounds = { INFINITY, INFINITY, -INFINITY, -INFINITY };
+
+        for (int i = 0; i < count; i++)
+        {
+            const double *r = &data[i * 4];
+            int x = static_cast<int>(r[0]), y = static_cast<int>(r[1]);
+            int w = static_cast<int>(r[2]), h = static_cast<int>(r[3]);
+
+            if ( w <= 0 || h <= 0 ) continue;
+
+            _sk_queue_rect(surface, clrs[i], x, y, w, h);
+            _sk_grow_bounds(bounds, r[0], r[1], r[0] + r[2], r[1] + r[3]);
+        }
+
+        _sk_submit_instanced(surface, bounds);
+    }
+
+    // 3 values per circle = centre x, centre y, radius
+    void sk_fill_circles(sk_drawing_surface *surface, const sk_color *clrs, const double *data, int count)
+    {
+        if ( ! surface || ! surface->_data || ! clrs || ! data ) return;
+
+        _sk_bounds bounds = { INFINITY, INFINITY, -INFINITY, -INFINITY };
+
+        for (int i = 0; i < count; i++)
+        {
+            const double *c = &data[i * 3];
+            int x = static_cast<int>(c[0]), y = static_cast<int>(c[1]);
+            int r = static_cast<int>(c[2]);
+
+            _sk_queue_ellipse(surface, clrs[i], x + 0.5f, y + 0.5f, r + 0.5f, r + 0.5f);
+            _sk_grow_bounds(bounds, c[0] - c[2], c[1] - c[2], c[0] + c[2], c[1] + c[2]);
+        }
+
+        _sk_submit_instanced(surface, bounds);
+    }
+
+    // 4 values per line = x1, y1, x2, y2
+    void sk_draw_lines(sk_drawing_surface *surface, const sk_color *clrs, const double *data, int count, double size)
+    {
+        if ( ! surface || ! surface->_data || ! clrs || ! data ) return;
+
+        int w = static_cast<int>(size);
+        if ( w == 0 ) return;
+
+        _sk_bounds bounds = { INFINITY, INFINITY, -INFINITY, -INFINITY };
+
+        for (int i = 0; i < count; i++)
+        {
+            const double *l = &data[i * 4];
+
+            _sk_queue_line(surface, clrs[i], static_cast<int>(l[0]), static_cast<int>(l[1]), static_cast<int>(l[2]), static_cast<int>(l[3]), w);
+            _sk_grow_bounds(bounds, l[0], l[1], l[2], l[3]);
+        }
+
+        bounds.min_x -= size / 2; bounds.min_y -= size / 2;
+        bounds.max_x += size / 2; bounds.max_y += size / 2;
+
+        _sk_submit_instanced(surface, bounds);
+    }
+
 
     //
     //  Rectangles
@@ -964,6 +1755,8 @@ namespace splashkit_lib
     {
         if ( (! surface) || (! surface->_data) ) return;
 
+        _sk_mark_dirty(surface, x, y, width, height);
+
         SDL_Rect rect = {
             static_cast<int>(x),
             static_cast<int>(y),
@@ -971,16 +1764,23 @@ namespace splashkit_lib
             static_cast<int>(height)
         };
 
+        if ( _sk_deferred )
+        {
+            float fx = rect.x, fy = rect.y, fw = rect.w, fh = rect.h;
+
+            _sk_queue_rect(surface, clr, fx, fy, fw, 1);
+            _sk_queue_rect(surface, clr, fx, fy + fh - 1, fw, 1);
+            _sk_queue_rect(surface, clr, fx, fy + 1, 1, fh - 2);
+            _sk_queue_rect(surface, clr, fx + fw - 1, fy + 1, 1, fh - 2);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
         {
             SDL_Renderer *renderer = _sk_prepared_renderer(surface, i);
-            SDL_SetRenderDrawColor(renderer,
-                                   static_cast<Uint8>(clr.r * 255),
-                                   static_cast<Uint8>(clr.g * 255),
-                                   static_cast<Uint8>(clr.b * 255),
-                                   static_cast<Uint8>(clr.a * 255));
+            _sk_set_draw_color(renderer, clr);
 
             SDL_RenderDrawRect(renderer, &rect);
 
@@ -992,6 +1792,8 @@ namespace splashkit_lib
     {
         if ( (! surface) || (! surface->_data)  ) return;
 
+        _sk_mark_dirty(surface, x, y, width, height);
+
         SDL_Rect rect = {
             static_cast<int>(x),
             static_cast<int>(y),
@@ -999,16 +1801,18 @@ namespace splashkit_lib
             static_cast<int>(height)
         };
 
+        if ( _sk_deferred )
+        {
+            _sk_queue_rect(surface, clr, rect.x, rect.y, rect.w, rect.h);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
         {
             SDL_Renderer *renderer = _sk_prepared_renderer(surface, i);
-            SDL_SetRenderDrawColor(renderer,
-                                   static_cast<Uint8>(clr.r * 255),
-                                   static_cast<Uint8>(clr.g * 255),
-                                   static_cast<Uint8>(clr.b * 255),
-                                   static_cast<Uint8>(clr.a * 255));
+            _sk_set_draw_color(renderer, clr);
 
             SDL_RenderFillRect(renderer, &rect);
 
@@ -1030,22 +1834,29 @@ namespace splashkit_lib
         if ( (! surface) || ! surface->_data ) return;
         if ( data_sz != 8 ) return;
 
+        _sk_mark_dirty_points(surface, data, 4, 0);
+
         // 8 values = 4 points
         int x1 = static_cast<int>(data[0]), y1 = static_cast<int>(data[1]);
         int x2 = static_cast<int>(data[2]), y2 = static_cast<int>(data[3]);
         int x3 = static_cast<int>(data[4]), y3 = static_cast<int>(data[5]);
         int x4 = static_cast<int>(data[6]), y4 = static_cast<int>(data[7]);
 
+        if ( _sk_deferred )
+        {
+            _sk_queue_line(surface, clr, x1, y1, x2, y2, 1);
+            _sk_queue_line(surface, clr, x1, y1, x3, y3, 1);
+            _sk_queue_line(surface, clr, x4, y4, x2, y2, 1);
+            _sk_queue_line(surface, clr, x4, y4, x3, y3, 1);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
         {
             SDL_Renderer *renderer = _sk_prepared_renderer(surface, i);
-            SDL_SetRenderDrawColor(renderer,
-                                   static_cast<Uint8>(clr.r * 255),
-                                   static_cast<Uint8>(clr.g * 255),
-                                   static_cast<Uint8>(clr.b * 255),
-                                   static_cast<Uint8>(clr.a * 255));
+            _sk_set_draw_color(renderer, clr);
 
             SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
             SDL_RenderDrawLine(renderer, x1, y1, x3, y3);
@@ -1069,6 +1880,8 @@ namespace splashkit_lib
         if ( ! surface ) return;
         if ( data_sz != 8 ) return;
 
+        _sk_mark_dirty_points(surface, data, 4, 0);
+
         // 8 values = 4 points
         Sint16 x[4], y[4];
 
@@ -1082,6 +1895,16 @@ namespace splashkit_lib
         y[2] = static_cast<Sint16>(data[7]);    // Swap last 2 for SDL_gfx order
         y[3] = static_cast<Sint16>(data[5]);
 
+        if ( _sk_deferred )
+        {
+            // x and y are already in order around the edge
+            SDL_FPoint pts[4];
+            for (int i = 0; i < 4; i++) pts[i] = { static_cast<float>(x[i]), static_cast<float>(y[i]) };
+
+            _sk_queue_polygon(surface, clr, pts, 4);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
@@ -1097,10 +1920,8 @@ namespace splashkit_lib
                               a
                               );
 
-            if ( a == 255 ) // SDL_Gfx changes renderer state ... undo change here
-            {
-                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            }
+            // SDL_gfx changes the renderer's draw state
+            _sk_forget_draw_state(renderer);
 
             _sk_complete_render(surface, i);
         }
@@ -1116,21 +1937,28 @@ namespace splashkit_lib
     {
         if ( ! surface || ! surface->_data ) return;
 
+        double pts[6] = { x1, y1, x2, y2, x3, y3 };
+        _sk_mark_dirty_points(surface, pts, 3, 0);
+
         // 6 values = 3 points
         int px1 = static_cast<int>(x1), py1 = static_cast<int>(y1);
         int px2 = static_cast<int>(x2), py2 = static_cast<int>(y2);
         int px3 = static_cast<int>(x3), py3 = static_cast<int>(y3);
 
+        if ( _sk_deferred )
+        {
+            _sk_queue_line(surface, clr, px1, py1, px2, py2, 1);
+            _sk_queue_line(surface, clr, px2, py2, px3, py3, 1);
+            _sk_queue_line(surface, clr, px3, py3, px1, py1, 1);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
         {
             SDL_Renderer *renderer = _sk_prepared_renderer(surface, i);
-            SDL_SetRenderDrawColor(renderer,
-                                   static_cast<Uint8>(clr.r * 255),
-                                   static_cast<Uint8>(clr.g * 255),
-                                   static_cast<Uint8>(clr.b * 255),
-                                   static_cast<Uint8>(clr.a * 255));
+            _sk_set_draw_color(renderer, clr);
 
             SDL_RenderDrawLine(renderer, px1, py1, px2, py2);
             SDL_RenderDrawLine(renderer, px2, py2, px3, py3);
@@ -1144,6 +1972,21 @@ namespace splashkit_lib
     {
         if ( ! surface || ! surface->_data ) return;
 
+        double pts[6] = { x1, y1, x2, y2, x3, y3 };
+        _sk_mark_dirty_points(surface, pts, 3, 0);
+
+        if ( _sk_deferred )
+        {
+            SDL_FPoint pts[3] = {
+                { static_cast<float>(x1), static_cast<float>(y1) },
+                { static_cast<float>(x2), static_cast<float>(y2) },
+                { static_cast<float>(x3), static_cast<float>(y3) }
+            };
+
+            _sk_queue_polygon(surface, clr, pts, 3);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
@@ -1160,10 +2003,8 @@ namespace splashkit_lib
                              a
                              );
 
-            if ( a == 255 ) // SDL_Gfx changes renderer state ... undo change here
-            {
-                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            }
+            // SDL_gfx changes the renderer's draw state
+            _sk_forget_draw_state(renderer);
 
             _sk_complete_render(surface, i);
         }
@@ -1177,6 +2018,8 @@ namespace splashkit_lib
     {
         if ( ! surface || ! surface->_data ) return;
 
+        _sk_mark_dirty(surface, x, y, width, height);
+
         // 4 values = 1 point w + h
         int x1 = static_cast<int>(x), y1 = static_cast<int>(y);
         int w = static_cast<int>(width), h = static_cast<int>(height);
@@ -1196,10 +2039,8 @@ namespace splashkit_lib
                         static_cast<Uint8>(clr.g * 255),
                         static_cast<Uint8>(clr.b * 255), a);
 
-            if ( a == 255 ) // SDL_Gfx changes renderer state ... undo change here
-            {
-                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            }
+            // SDL_gfx changes the renderer's draw state
+            _sk_forget_draw_state(renderer);
 
             _sk_complete_render(surface, i);
         }
@@ -1209,10 +2050,18 @@ namespace splashkit_lib
     {
         if ( ! surface || ! surface->_data ) return;
 
+        _sk_mark_dirty(surface, x, y, width, height);
+
         // 4 values = 1 point w + h
         int x1 = static_cast<int>(x), y1 = static_cast<int>(y);
         int w = static_cast<int>(width), h = static_cast<int>(height);
 
+        if ( _sk_deferred )
+        {
+            _sk_queue_ellipse(surface, clr, x1 + w / 2 + 0.5f, y1 + h / 2 + 0.5f, w / 2 + 0.5f, h / 2 + 0.5f);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
@@ -1228,10 +2077,8 @@ namespace splashkit_lib
                               static_cast<Uint8>(clr.g * 255),
                               static_cast<Uint8>(clr.b * 255), a);
 
-            if ( a == 255 ) // SDL_Gfx changes renderer state ... undo change here
-            {
-                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            }
+            // SDL_gfx changes the renderer's draw state
+            _sk_forget_draw_state(renderer);
 
             _sk_complete_render(surface, i);
         }
@@ -1246,16 +2093,20 @@ namespace splashkit_lib
     {
         if ( ! surface || ! surface->_data ) return;
 
+        _sk_mark_dirty(surface, x, y, 1, 1);
+
+        if ( _sk_deferred )
+        {
+            _sk_queue_rect(surface, clr, static_cast<int>(x), static_cast<int>(y), 1, 1);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
         {
             SDL_Renderer *renderer = _sk_prepared_renderer(surface, i);
-            SDL_SetRenderDrawColor(renderer,
-                                   static_cast<Uint8>(clr.r * 255),
-                                   static_cast<Uint8>(clr.g * 255),
-                                   static_cast<Uint8>(clr.b * 255),
-                                   static_cast<Uint8>(clr.a * 255));
+            _sk_set_draw_color(renderer, clr);
 
             // The following works with multisampling on... use if we
             // want multisampling... otherwise use the following
@@ -1275,6 +2126,9 @@ namespace splashkit_lib
     }
 
 
+    // Single pixel reads of a surface before all of its pixels are read at once
+    const unsigned int _SK_READS_BEFORE_COPY = 16;
+
     sk_color sk_read_pixel(sk_drawing_surface *surface, int x, int y)
     {
         sk_color result = {0,0,0,0};
@@ -1289,26 +2143,210 @@ namespace splashkit_lib
 
         if ( ! surface || ! surface->_data ) return result;
 
-        if ( _sk_num_open_windows == 0 ) _sk_create_initial_window();
+        sk_flush_drawing_surface(surface);
+
+        sk_pixel_shadow *shadow = _sk_current_pixel_shadow(surface);
+
+        if ( ! shadow )
+        {
+            // After many reads with no drawing in between, read all of the
+            // pixels once and use that copy for the rest
+            unsigned int version;
+            sk_pixel_shadow *reads = _sk_pixel_shadow(surface, version);
+
+            if ( reads && reads->read_version != version )
+            {
+                reads->read_version = version;
+                reads->reads = 0;
+            }
+
+            if ( reads && ++reads->reads > _SK_READS_BEFORE_COPY )
+            {
+                sk_lock_pixels(surface, nullptr);
+                sk_unlock_pixels(surface, false);
+                shadow = _sk_current_pixel_shadow(surface);
+            }
+        }
+
+        if ( shadow )
+        {
+            // Nothing has been drawn since the pixels were read
+            if ( x < 0 || y < 0 || x >= shadow->width || y >= shadow->height ) return result;
+            clr = static_cast<unsigned int>(shadow->pixels[y * shadow->width + x]);
+        }
+        else
+        {
+            if ( _sk_num_open_windows == 0 ) _sk_create_initial_window();
+
+            // Reading does not change the surface, so avoid _sk_prepared_renderer
+            SDL_Renderer *renderer;
+            if ( surface->kind == SGDS_Bitmap )
+            {
+                renderer = _sk_bitmap_renderer(static_cast<sk_bitmap_be *>(surface->_data));
+            }
+            else
+            {
+                sk_window_be *window_be = static_cast<sk_window_be *>(surface->_data);
+                _sk_restore_default_render_target(window_be);
+                renderer = window_be->renderer;
+            }
 
-        SDL_Renderer *renderer = _sk_prepared_renderer(surface, 0);
+            SDL_RenderReadPixels(renderer,
+                                 &rect,
+                                 SDL_PIXELFORMAT_RGBA8888,
+                                 &clr,
+                                 4 * surface->width );
+        }
 
-        SDL_RenderReadPixels(renderer,
-                             &rect,
-                             SDL_PIXELFORMAT_RGBA8888,
-                             &clr,
-                             4 * surface->width );
         result.a = (clr & 0x000000ff) / 255.0f;
         result.r = ((clr & 0xff000000) >> 24) / 255.0f;
         result.g = ((clr & 0x00ff0000) >> 16) / 255.0f;
         result.b = ((clr & 0x0000ff00) >> 8) / 255.0f;
 
-        _sk_complete_render(surface, 0);
-
         return result;
     }
 
 
+    //
+    // Bulk pixel access
+    //
+
+    //
+    // Get the surface's shadow copy, and the surface's current version
+    //
+    sk_pixel_shadow *_sk_pixel_shadow(sk_drawing_surface *surface, unsigned int &version)
+    {
+        switch (surface->kind)
+        {
+            case SGDS_Window:
+            {
+                sk_window_be *window_be = static_cast<sk_window_be *>(surface->_data);
+                version = window_be->version;
+                return &window_be->shadow;
+            }
+
+            case SGDS_Bitmap:
+            {
+                sk_bitmap_be *bitmap_be = static_cast<sk_bitmap_be *>(surface->_data);
+                version = bitmap_be->version;
+                return &bitmap_be->shadow;
+            }
+
+            case SGDS_Unknown:
+            default:
+                return nullptr;
+        }
+    }
+
+    //
+    // The surface's shadow copy if it still matches the surface, or nullptr
+    // if there has been drawing since it was read. Flush the surface first.
+    //
+    sk_pixel_shadow *_sk_current_pixel_shadow(sk_drawing_surface *surface)
+    {
+        unsigned int version;
+        sk_pixel_shadow *shadow = _sk_pixel_shadow(surface, version);
+
+        if ( shadow && shadow->pixels && shadow->version == version &&
+             shadow->width == surface->width && shadow->height == surface->height )
+        {
+            return shadow;
+        }
+
+        return nullptr;
+    }
+
+    //
+    // Get the surface's pixels in memory, reading them from the GPU only if
+    // there has been drawing since they were last read. The pitch is the
+    // number of bytes in each row. Do not draw onto the surface until the
+    // pixels are unlocked.
+    //
+    int * sk_lock_pixels(sk_drawing_surface *surface, int *pitch)
+    {
+        if ( ! surface || ! surface->_data ) return nullptr;
+
+        sk_flush_drawing_surface(surface);
+
+        unsigned int version;
+        sk_pixel_shadow *shadow = _sk_pixel_shadow(surface, version);
+
+        if ( ! shadow ) return nullptr;
+
+        if ( ! _sk_current_pixel_shadow(surface) )
+        {
+            if ( ! shadow->pixels || shadow->width != surface->width || shadow->height != surface->height )
+            {
+                free(shadow->pixels);
+                shadow->pixels = static_cast<int *>(malloc(sizeof(int) * static_cast<size_t>(surface->width * surface->height)));
+                shadow->width = surface->width;
+                shadow->height = surface->height;
+            }
+
+            sk_to_pixels(surface, shadow->pixels, shadow->width * shadow->height);
+            shadow->version = version;
+        }
+
+        shadow->locked = true;
+
+        if ( pitch ) *pitch = 4 * shadow->width;
+        return shadow->pixels;
+    }
+
+    //
+    // Finish with the locked pixels. Changes go back to the GPU in one
+    // texture update.
+    //
+    void sk_unlock_pixels(sk_drawing_surface *surface, bool changed)
+    {
+        if ( ! surface || ! surface->_data ) return;
+
+        unsigned int version;
+        sk_pixel_shadow *shadow = _sk_pixel_shadow(surface, version);
+
+        if ( ! shadow || ! shadow->locked ) return;
+
+        shadow->locked = false;
+
+        // Skip if unchanged, or if the surface was resized while locked
+        if ( ! changed || shadow->width != surface->width || shadow->height != surface->height ) return;
+
+        SDL_Texture *tex;
+
+        if ( surface->kind == SGDS_Window )
+        {
+            sk_window_be *window_be = static_cast<sk_window_be *>(surface->_data);
+            tex = window_be->backing;
+
+            window_be->version++;
+            _sk_mark_window_dirty(window_be);
+            shadow->version = window_be->version;
+        }
+        else
+        {
+            sk_bitmap_be *bitmap_be = static_cast<sk_bitmap_be *>(surface->_data);
+
+            // The owner's texture must be RGBA8888, like the pixels
+            if ( ! bitmap_be->drawable ) _sk_make_drawable( bitmap_be );
+            tex = bitmap_be->texture[bitmap_be->owner];
+
+            bitmap_be->version++;
+            shadow->version = bitmap_be->version;
+        }
+
+#ifdef WINDOWS
+        // Texture is inverted so the rows go in reverse
+        for (int row = 0; row < shadow->height; row++)
+        {
+            SDL_Rect rect = { 0, shadow->height - row - 1, shadow->width, 1 };
+            SDL_UpdateTexture(tex, &rect, &shadow->pixels[row * shadow->width], 4 * shadow->width);
+        }
+#else
+        SDL_UpdateTexture(tex, nullptr, shadow->pixels, 4 * shadow->width);
+#endif
+    }
+
+
     //
     // Circles
     //
@@ -1317,6 +2355,8 @@ namespace splashkit_lib
     {
         if ( ! surface || ! surface->_data ) return;
 
+        _sk_mark_dirty(surface, x - radius, y - radius, radius * 2, radius * 2);
+
         // 3 values = 1 point + radius
         int x1 = static_cast<int>(x), y1 = static_cast<int>(y);
         int r = static_cast<int>(radius);
@@ -1339,10 +2379,8 @@ namespace splashkit_lib
                        a
                        );
 
-            if ( a == 255 ) // SDL_Gfx changes renderer state ... undo change here
-            {
-                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            }
+            // SDL_gfx changes the renderer's draw state
+            _sk_forget_draw_state(renderer);
 
             _sk_complete_render(surface, i);
         }
@@ -1352,10 +2390,18 @@ namespace splashkit_lib
     {
         if ( ! surface || ! surface->_data ) return;
 
+        _sk_mark_dirty(surface, x - radius, y - radius, radius * 2, radius * 2);
+
         // 3 values = 1 point + radius
         int x1 = static_cast<int>(x), y1 = static_cast<int>(y);
         int r = static_cast<int>(radius);
 
+        if ( _sk_deferred )
+        {
+            _sk_queue_ellipse(surface, clr, x1 + 0.5f, y1 + 0.5f, r + 0.5f, r + 0.5f);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
@@ -1374,10 +2420,8 @@ namespace splashkit_lib
                              a
                              );
 
-            if ( a == 255 ) // SDL_Gfx changes renderer state ... undo change here
-            {
-                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            }
+            // SDL_gfx changes the renderer's draw state
+            _sk_forget_draw_state(renderer);
 
             _sk_complete_render(surface, i);
         }
@@ -1392,6 +2436,9 @@ namespace splashkit_lib
     {
         if ( ! surface || ! surface->_data ) return;
 
+        double pts[4] = { x1, y1, x2, y2 };
+        _sk_mark_dirty_points(surface, pts, 2, size / 2);
+
         // 4 values = 2 points
         int x1i = static_cast<int>(x1), y1i = static_cast<int>(y1);
         int x2i = static_cast<int>(x2), y2i = static_cast<int>(y2);
@@ -1401,6 +2448,12 @@ namespace splashkit_lib
 
         if ( w == 0 ) return;
 
+        if ( _sk_deferred )
+        {
+            _sk_queue_line(surface, clr, x1i, y1i, x2i, y2i, w);
+            return;
+        }
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
@@ -1409,11 +2462,7 @@ namespace splashkit_lib
 
             if ( w == 1)
             {
-                SDL_SetRenderDrawColor(renderer,
-                                       static_cast<Uint8>(clr.r * 255),
-                                       static_cast<Uint8>(clr.g * 255),
-                                       static_cast<Uint8>(clr.b * 255),
-                                       static_cast<Uint8>(clr.a * 255));
+                _sk_set_draw_color(renderer, clr);
 
                 SDL_RenderDrawLine(renderer, x1i, y1i, x2i, y2i);
             }
@@ -1429,6 +2478,9 @@ namespace splashkit_lib
                               static_cast<Uint8>(clr.g * 255),
                               static_cast<Uint8>(clr.b * 255),
                               static_cast<Uint8>(clr.a * 255));
+
+                // SDL_gfx changes the renderer's draw state
+                _sk_forget_draw_state(renderer);
             }
             _sk_complete_render(surface, i);
         }
@@ -1447,6 +2499,9 @@ namespace splashkit_lib
         int x1 = static_cast<int>(x), y1 = static_cast<int>(y);
         int w = static_cast<int>(width), h = static_cast<int>(height);
 
+        // Queued geometry was drawn with the old clip
+        sk_flush_drawing_surface(surface);
+
         switch (surface->kind) {
             case SGDS_Window:
             {
@@ -1456,7 +2511,7 @@ namespace splashkit_lib
                 window_be->clipped = true;
                 window_be->clip = { x1, y1, w, h };
 
-                SDL_RenderSetClipRect(window_be->renderer, &window_be->clip);
+                _sk_restore_default_render_target(window_be);
                 break;
             }
             case SGDS_Bitmap:
@@ -1477,6 +2532,8 @@ namespace splashkit_lib
 
     void sk_clear_clip_rect(sk_drawing_surface *surface)
     {
+        sk_flush_drawing_surface(surface);
+
         switch (surface->kind)
         {
             case SGDS_Window:
@@ -1486,7 +2543,7 @@ namespace splashkit_lib
 
                 window_be->clipped = false;
                 window_be->clip = { 0, 0, surface->width, surface->height };
-                SDL_RenderSetClipRect(window_be->renderer, nullptr);
+                _sk_restore_default_render_target(window_be);
                 //SDL_RenderPresent(window_be->renderer);
                 break;
             }
@@ -1589,6 +2646,17 @@ namespace splashkit_lib
     {
         if ( ! surface || ! surface->_data || surface->width * surface->height != sz) return;
 
+        sk_flush_drawing_surface(surface);
+
+        // Use the locked copy if nothing has been drawn since it was read
+        sk_pixel_shadow *shadow = _sk_current_pixel_shadow(surface);
+
+        if ( shadow && shadow->pixels != pixels )
+        {
+            memcpy(pixels, shadow->pixels, sizeof(int) * static_cast<size_t>(sz));
+            return;
+        }
+
         switch (surface->kind)
         {
             case SGDS_Window:
@@ -1597,6 +2665,7 @@ namespace splashkit_lib
                 window_be = static_cast<sk_window_be *>(surface->_data);
 
                 // read pixels from the texture
+                _sk_restore_default_render_target(window_be);
                 _sk_get_pixels_from_renderer(window_be->renderer, 0, 0, surface->width, surface->height, pixels);
 
                 break;
@@ -1610,6 +2679,15 @@ namespace splashkit_lib
                 {
                     _sk_bitmap_be_texture_to_pixels(bitmap_be, pixels, sz, surface->width, surface->height);
                 }
+                else if ( bitmap_be->surface->format->format == SDL_PIXELFORMAT_RGBA8888 )
+                {
+                    // already in the right format, so copy row by row
+                    SDL_Surface *src = bitmap_be->surface;
+                    for (int y = 0; y < surface->height; y++)
+                    {
+                        memcpy(&pixels[y * surface->width], static_cast<Uint8 *>(src->pixels) + y * src->pitch, sizeof(int) * static_cast<size_t>(surface->width));
+                    }
+                }
                 else
                 {
                     // read from surface
@@ -1645,7 +2723,7 @@ namespace splashkit_lib
         {
             case SGDS_Window:
             {
-                SDL_SetWindowBordered(window_be->window, border ? SDL_TRUE : SDL_FALSE);
+                if ( window_be->window ) SDL_SetWindowBordered(window_be->window, border ? SDL_TRUE : SDL_FALSE);
                 SDL_PumpEvents();
                 break;
             }
@@ -1669,7 +2747,7 @@ namespace splashkit_lib
         {
             case SGDS_Window:
             {
-                SDL_SetWindowFullscreen(window_be->window, fullscreen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0);
+                if ( window_be->window ) SDL_SetWindowFullscreen(window_be->window, fullscreen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0);
                 SDL_PumpEvents();
                 break;
             }
@@ -1695,36 +2773,38 @@ namespace splashkit_lib
             {
                 SDL_Rect dst = {0, 0, surface->width, surface->height};
 
+                _sk_flush_window_geometry(window_be);
+
                 // Get old backing texture
                 SDL_Texture * old = window_be->backing;
 
                 // Set renderer to draw onto window
-                SDL_SetRenderTarget(window_be->renderer, nullptr);
+                _sk_state_target(window_be, nullptr);
 
-                // Change window size
-                SDL_SetWindowSize(window_be->window, width, height);
+                // Change window size -- a headless canvas keeps its size, as the
+                // backing texture is what gets read and saved
+                if ( window_be->window ) SDL_SetWindowSize(window_be->window, width, height);
                 surface->width = width;
                 surface->height = height;
 
                 // Clear new window surface
-                SDL_RenderSetClipRect(window_be->renderer, nullptr);
-                SDL_SetRenderDrawColor(window_be->renderer, 120, 120, 120, 255);
+                _sk_state_clip(window_be, nullptr);
+                _sk_set_draw_color(window_be->renderer, 120, 120, 120, 255);
                 SDL_RenderClear(window_be->renderer);
 
                 // Create new backing
                 window_be->backing = SDL_CreateTexture(window_be->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
                 
                 // Copy across old display data
-                SDL_SetRenderTarget(window_be->renderer, window_be->backing);
+                _sk_state_target(window_be, window_be->backing);
                 SDL_RenderClear(window_be->renderer);
                 SDL_RenderCopy(window_be->renderer, old, nullptr, &dst);
                 SDL_RenderPresent(window_be->renderer);
                 
                 // Restore clipping
-                if ( window_be->clipped )
-                {
-                    SDL_RenderSetClipRect(window_be->renderer, &window_be->clip);
-                }
+                _sk_restore_default_render_target(window_be);
+                window_be->version++;
+                _sk_mark_window_dirty(window_be);
                 
                 // Delete old backing texture
                 SDL_DestroyTexture(old);
@@ -1741,87 +2821,271 @@ namespace splashkit_lib
         }
     }
     
-    // Saving a surface to a png file
-    void png_user_warn(png_structp ctx, png_const_charp str)
+    // Saving a surface to a png file
+    void png_user_warn(png_structp ctx, png_const_charp str)
+    {
+        //WriteLn(stderr, 'libpng: warning: ', str);
+    }
+    
+    void png_user_error(png_structp ctx, png_const_charp str)
+    {
+        //WriteLn(stderr, 'libpng: error: ', str);
+    }
+    
+    //
+    // Encode the pixels to the already open file, and close it. This only uses
+    // libpng, so it is safe to call from the png worker threads.
+    //
+    bool _sk_write_png(FILE *fp, const int *pixels, int width, int height)
+    {
+        png_structp png_ptr;
+        png_infop info_ptr;
+        int i, colortype;
+        png_bytepp row_pointers;
+        
+        // Initializing png structures and callbacks
+        png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, &png_user_error, &png_user_warn);
+        if (png_ptr == nullptr)
+        {
+            fclose(fp);
+            return false;
+        }
+        
+        info_ptr = png_create_info_struct(png_ptr);
+        if (info_ptr == nullptr)
+        {
+            png_destroy_write_struct(&png_ptr, nullptr);
+            fclose(fp);
+            return false;
+        }
+        
+        png_init_io(png_ptr, fp);
+        
+        colortype = PNG_COLOR_TYPE_RGBA;
+        png_set_IHDR( png_ptr, info_ptr,
+                     (png_uint_32)width, (png_uint_32)height, 8, colortype,
+                     PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+        
+        // Writing the image
+        png_write_info(png_ptr, info_ptr);
+        
+        png_set_packing(png_ptr);
+        png_set_swap_alpha(png_ptr);
+        png_set_bgr(png_ptr);
+        
+        row_pointers = (png_bytepp)png_malloc(png_ptr, (unsigned long)height * sizeof(png_bytep));
+        
+        for (i = 0; i < height; i++)
+        {
+            row_pointers[i] = png_bytep((const uint8_t *)pixels + i * width * 4);
+        }
+        
+        png_write_image(png_ptr, row_pointers);
+        png_write_end(png_ptr, info_ptr); // was ptr and nullptr
+        
+        // Cleaning out...
+        png_free(png_ptr, row_pointers);
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        
+        fclose(fp);
+        return true;
+    }
+    
+    int sk_save_png(sk_drawing_surface * surface, const char *filename)
+    {
+        if ( ! surface || ! surface->_data || surface->width <= 0 || surface->height <= 0  ) return 0;
+        
+        FILE *fp;
+        int sz;
+        int *pixels;
+        
+        // Opening output file
+        fp = fopen(filename, "wb");
+        
+        if (fp == nullptr) return 0;
+        
+        // actually get the pixel data...
+        sz = surface->width * surface->height;
+        pixels = (int *) malloc(sizeof(int) * (unsigned long)sz);
+        
+        sk_to_pixels(surface, pixels, sz);
+        
+        bool ok = _sk_write_png(fp, pixels, surface->width, surface->height);
+        free(pixels);
+        
+        return ok ? -1 : 0; // -1 is success
+    }
+    
+    
+    //--------------------------------------------------------------------------------------
+    //
+    // Saving pngs in the background
+    //
+    //--------------------------------------------------------------------------------------
+    
+    //
+    // The pixels are read on the calling thread, then worker threads do the
+    // slow zlib compression. Only _SK_PNG_MAX_JOBS saves can be waiting at
+    // once -- more saves block until one finishes, so memory stays bounded.
+    // Jobs and their pixel buffers are reused.
+    //
+    const int _SK_PNG_MAX_JOBS = 8;
+    const unsigned int _SK_PNG_MAX_WORKERS = 4;
+    
+    struct _sk_png_job
     {
-        //WriteLn(stderr, 'libpng: warning: ', str);
-    }
+        FILE *          fp;
+        int *           pixels;
+        int             capacity;   // pixels allocated
+        int             width, height;
+        std::promise<bool> result;
+    };
     
-    void png_user_error(png_structp ctx, png_const_charp str)
+    static channel<_sk_png_job *> _sk_png_jobs;
+    static semaphore _sk_png_slots(_SK_PNG_MAX_JOBS);
+    static vector<thread> _sk_png_workers;
+    
+    static mutex _sk_png_mutex;                 // guards the values below
+    static condition_variable _sk_png_done;
+    static vector<_sk_png_job *> _sk_free_png_jobs;
+    static unsigned int _sk_png_pending = 0;
+    
+    void _sk_png_worker()
     {
-        //WriteLn(stderr, 'libpng: error: ', str);
+        while ( true )
+        {
+            _sk_png_job *job = _sk_png_jobs.take();
+            
+            if ( ! job ) return; // asked to stop
+            
+            bool ok = _sk_write_png(job->fp, job->pixels, job->width, job->height);
+            job->fp = nullptr;
+            job->result.set_value(ok);
+            
+            {
+                lock_guard<mutex> lock(_sk_png_mutex);
+                _sk_free_png_jobs.push_back(job);
+                _sk_png_pending--;
+            }
+            
+            _sk_png_done.notify_all();
+            _sk_png_slots.release();
+        }
     }
     
-    int sk_save_png(sk_drawing_surface * surface, const char *filename)
+    void _sk_start_png_workers()
     {
-        if ( ! surface || ! surface->_data || surface->width <= 0 || surface->height <= 0  ) return 0;
-        
-        FILE *fp;
-        png_structp png_ptr;
-        png_infop info_ptr;
-        int i, colortype;
-        unsigned long sz;
-        png_bytepp row_pointers;
-        uint8_t *pixels;
+        if ( ! _sk_png_workers.empty() ) return;
         
-        // Opening output file
-        fp = fopen(filename, "wb");
+        unsigned int count = thread::hardware_concurrency();
         
-        if (fp == nullptr) return 0;
+        // leave a core for the program itself
+        if ( count > 1 ) count--;
+        if ( count < 1 ) count = 1;
+        if ( count > _SK_PNG_MAX_WORKERS ) count = _SK_PNG_MAX_WORKERS;
         
-        // Initializing png structures and callbacks
-        png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, &png_user_error, &png_user_warn);
-        if (png_ptr == nullptr)
+        for (unsigned int i = 0; i < count; i++)
         {
-            fclose(fp);
-            return 0;
+            _sk_png_workers.push_back(thread(_sk_png_worker));
         }
+    }
+    
+    std::shared_future<bool> sk_save_png_async(sk_drawing_surface * surface, const char *filename)
+    {
+        std::promise<bool> failed;
+        failed.set_value(false);
         
-        info_ptr = png_create_info_struct(png_ptr);
-        if (info_ptr == nullptr)
+        if ( ! surface || ! surface->_data || surface->width <= 0 || surface->height <= 0  ) return failed.get_future().share();
+        
+        // Opening the file now claims the filename and reports errors straight away
+        FILE *fp = fopen(filename, "wb");
+        
+        if (fp == nullptr) return failed.get_future().share();
+        
+        _sk_start_png_workers();
+        
+        // Wait for room in the queue
+        _sk_png_slots.acquire();
+        
+        _sk_png_job *job;
         {
-            png_destroy_write_struct(&png_ptr, nullptr);
-            fclose(fp);
-            return 0;
+            lock_guard<mutex> lock(_sk_png_mutex);
+            
+            if ( _sk_free_png_jobs.empty() )
+            {
+                job = new _sk_png_job;
+                job->pixels = nullptr;
+                job->capacity = 0;
+            }
+            else
+            {
+                job = _sk_free_png_jobs.back();
+                _sk_free_png_jobs.pop_back();
+            }
+            
+            _sk_png_pending++;
         }
         
-        png_init_io(png_ptr, fp);
+        int sz = surface->width * surface->height;
         
-        colortype = PNG_COLOR_TYPE_RGBA;
-        png_set_IHDR( png_ptr, info_ptr,
-                     (png_uint_32)surface->width, (png_uint_32)surface->height, 8, colortype,
-                     PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+        if ( job->capacity < sz )
+        {
+            free(job->pixels);
+            job->pixels = static_cast<int *>(malloc(sizeof(int) * static_cast<size_t>(sz)));
+            job->capacity = sz;
+        }
         
-        // Writing the image
-        png_write_info(png_ptr, info_ptr);
+        sk_to_pixels(surface, job->pixels, sz);
         
-        png_set_packing(png_ptr);
-        png_set_swap_alpha(png_ptr);
-        png_set_bgr(png_ptr);
+        job->fp = fp;
+        job->width = surface->width;
+        job->height = surface->height;
+        job->result = std::promise<bool>();
         
-        // actually get the pixel data...
-        sz = (unsigned long)(surface->width * surface->height) * sizeof(uint8_t);
-        pixels = (uint8_t *) malloc(sizeof(uint8_t) * sz * 4);
+        std::shared_future<bool> result = job->result.get_future().share();
         
-        sk_to_pixels(surface, (int *)pixels, (int)sz);
+        _sk_png_jobs.put(job);
         
-        row_pointers = (png_bytepp)png_malloc(png_ptr, (unsigned long)surface->height * sizeof(png_bytep));
+        return result;
+    }
+    
+    unsigned int sk_png_saves_pending()
+    {
+        lock_guard<mutex> lock(_sk_png_mutex);
+        return _sk_png_pending;
+    }
+    
+    void sk_wait_for_png_saves()
+    {
+        unique_lock<mutex> lock(_sk_png_mutex);
         
-        for (i = 0; i < surface->height; i++)
+        while ( _sk_png_pending > 0 )
         {
-            row_pointers[i] = png_bytep(pixels + i * surface->width * 4);
+            _sk_png_done.wait(lock);
         }
+    }
+    
+    void _sk_stop_png_workers()
+    {
+        sk_wait_for_png_saves();
         
-        png_write_image(png_ptr, row_pointers);
-        png_write_end(png_ptr, info_ptr); // was ptr and nullptr
+        for (unsigned int i = 0; i < _sk_png_workers.size(); i++)
+        {
+            _sk_png_jobs.put(nullptr);
+        }
         
-        // Cleaning out...
-        png_free(png_ptr, row_pointers);
-        png_destroy_write_struct(&png_ptr, &info_ptr);
-        free(pixels);
+        for (thread &worker : _sk_png_workers)
+        {
+            worker.join();
+        }
+        _sk_png_workers.clear();
         
-        fclose(fp);
-        return -1; // success
+        for (_sk_png_job *job : _sk_free_png_jobs)
+        {
+            free(job->pixels);
+            delete job;
+        }
+        _sk_free_png_jobs.clear();
     }
     
     
@@ -1850,109 +3114,192 @@ namespace splashkit_lib
         data->clip = {0, 0, width, height};
         data->drawable = true;
         data->surface = nullptr;
-        data->texture = static_cast<SDL_Texture **>(malloc(sizeof(SDL_Texture*) * _sk_num_open_windows));
+        data->pending = nullptr;
+        _sk_init_pixel_shadow(data->shadow);
+        data->texture = static_cast<SDL_Texture **>(calloc(_sk_num_open_windows, sizeof(SDL_Texture*)));
+        data->texture_version = static_cast<unsigned int *>(calloc(_sk_num_open_windows, sizeof(unsigned int)));
+        data->version = 0;
         
-        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
-        {
-            data->texture[i] = SDL_CreateTexture(_sk_open_windows[i]->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
-            
-            SDL_SetTextureBlendMode(data->texture[i], SDL_BLENDMODE_BLEND);
-            
-            _sk_set_renderer_target(i, data);
-            SDL_SetRenderDrawColor(_sk_open_windows[i]->renderer, 255, 255, 255, 0);
-            SDL_RenderClear(_sk_open_windows[i]->renderer);
-            SDL_RenderPresent(_sk_open_windows[i]->renderer);
-            _sk_restore_default_render_target(i, data);
-        }
+        // Only the first window gets a texture, others copy it when they draw the bitmap
+        data->owner = 0;
+        data->texture[0] = SDL_CreateTexture(_sk_open_windows[0]->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        
+        SDL_SetTextureBlendMode(data->texture[0], SDL_BLENDMODE_BLEND);
+        
+        _sk_set_renderer_target(data);
+        _sk_set_draw_color(_sk_open_windows[0]->renderer, 255, 255, 255, 0);
+        SDL_RenderClear(_sk_open_windows[0]->renderer);
+        SDL_RenderPresent(_sk_open_windows[0]->renderer);
         
         _sk_add_bitmap(data);
         return result;
     }
     
-    sk_drawing_surface sk_load_bitmap(const char * filename)
+    void sk_init_image_decoding()
     {
+        static bool done = false;
+
         internal_sk_init();
-        sk_drawing_surface result = { SGDS_Unknown, 0, 0, nullptr };
-        
-        SDL_Surface *surface;
-        
-        surface = IMG_Load(filename);
-        
-        if ( ! surface ) {
+        if ( done ) return;
+        done = true;
+
+        // Load every codec up front, as IMG_Load loading them on demand is
+        // not safe from several threads at once. Other formats are built in.
+        int formats = IMG_INIT_PNG | IMG_INIT_JPG | IMG_INIT_TIF | IMG_INIT_WEBP;
+#ifdef SDL_IMAGE_VERSION_ATLEAST
+#if SDL_IMAGE_VERSION_ATLEAST(2, 6, 0)
+        formats |= IMG_INIT_AVIF | IMG_INIT_JXL;
+#endif
+#endif
+        IMG_Init(formats);
+    }
+
+    //
+    // Decode an image into RGBA8888 pixels. This does not touch any renderer,
+    // so it can run on any thread once sk_init_image_decoding has been called.
+    //
+    sk_decoded_bitmap sk_decode_bitmap(const char * filename)
+    {
+        sk_decoded_bitmap result = { 0, 0, nullptr };
+
+        SDL_Surface *loaded = IMG_Load(filename);
+
+        if ( ! loaded )
+        {
             std::cout << "error loading image " << IMG_GetError() << std::endl;
             return result;
         }
+
+        // Match the pixel format of sk_to_pixels so the pixels can be used directly
+        SDL_Surface *surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA8888, 0);
+        SDL_FreeSurface(loaded);
+
+        if ( ! surface )
+        {
+            std::cout << "error converting image " << SDL_GetError() << std::endl;
+            return result;
+        }
+
+        result.width = surface->w;
+        result.height = surface->h;
+        result._data = surface;
+
+        return result;
+    }
+
+    const int * sk_decoded_pixels(sk_decoded_bitmap *image)
+    {
+        if ( ! image || ! image->_data ) return nullptr;
+
+        // 32 bit rows are never padded, so the pixels are width * height ints
+        return static_cast<const int *>(static_cast<SDL_Surface *>(image->_data)->pixels);
+    }
+
+    void sk_free_decoded_bitmap(sk_decoded_bitmap *image)
+    {
+        if ( ! image || ! image->_data ) return;
+
+        SDL_FreeSurface(static_cast<SDL_Surface *>(image->_data));
+        image->_data = nullptr;
+    }
+
+    //
+    // Turn a decoded image into a bitmap, taking ownership of its pixels. When
+    // a window is open the texture is uploaded now, otherwise it is created
+    // when the bitmap is first drawn.
+    //
+    sk_drawing_surface sk_load_decoded_bitmap(sk_decoded_bitmap *image)
+    {
+        internal_sk_init();
+        sk_drawing_surface result = { SGDS_Unknown, 0, 0, nullptr };
+
+        if ( ! image || ! image->_data ) return result;
+
+        SDL_Surface *surface = static_cast<SDL_Surface *>(image->_data);
+        image->_data = nullptr;
+
         sk_bitmap_be *data = static_cast<sk_bitmap_be *>(malloc(sizeof(sk_bitmap_be)));
         
         result._data = data;
         
-        // Allocate space for one texture per window
+        // Allocate space for one texture per window -- these are created from
+        // the surface when each window first draws the bitmap
         if (_sk_num_open_windows > 0)
-            data->texture = static_cast<SDL_Texture **>(malloc(sizeof(SDL_Texture*) * _sk_num_open_windows));
+        {
+            data->texture = static_cast<SDL_Texture **>(calloc(_sk_num_open_windows, sizeof(SDL_Texture*)));
+            data->texture_version = static_cast<unsigned int *>(calloc(_sk_num_open_windows, sizeof(unsigned int)));
+        }
         else
-            data->texture = nullptr;
-        
-        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
         {
-            // Create a texture for each window
-            data->texture[i] = SDL_CreateTextureFromSurface(_sk_open_windows[i]->renderer, surface);
+            data->texture = nullptr;
+            data->texture_version = nullptr;
         }
+        data->version = 0;
+        data->owner = UINT_MAX;
         
         data->surface = surface;
         data->drawable = false;
         data->clipped = false;
         data->clip = {0,0,0,0};
+        data->pending = nullptr;
+        _sk_init_pixel_shadow(data->shadow);
         
         result.kind = SGDS_Bitmap;
         result.width = surface->w;
         result.height = surface->h;
         
         _sk_add_bitmap(data);
+
+        if ( _sk_num_open_windows > 0 )
+        {
+            _sk_bitmap_texture(data, 0);
+        }
         
         return result;
     }
+
+    sk_drawing_surface sk_load_bitmap(const char * filename)
+    {
+        sk_init_image_decoding();
+
+        sk_decoded_bitmap image = sk_decode_bitmap(filename);
+        if ( ! image._data )
+        {
+            sk_drawing_surface result = { SGDS_Unknown, 0, 0, nullptr };
+            return result;
+        }
+
+        return sk_load_decoded_bitmap(&image);
+    }
     
-    //x, y is the position to draw the bitmap to. As bitmaps scale around their centre, (x, y) is the top-left of the bitmap IF and ONLY IF scale = 1.
-    //Angle is in degrees, 0 being right way up
-    //Centre is the point to rotate around, relative to the bitmap centre (therefore (0,0) would rotate around the centre point)
-    void sk_draw_bitmap( sk_drawing_surface * src, sk_drawing_surface * dst, double * src_data, int src_data_sz, double * dst_data, int dst_data_sz, sk_renderer_flip flip )
+    //
+    // Work out the source and destination rectangles for drawing a bitmap,
+    // and the centre of rotation relative to the destination's top-left.
+    // Returns false when nothing is to be drawn.
+    //
+    static bool _sk_bitmap_rects(const double *src_data, const double *dst_data, SDL_Rect &src_rect, SDL_Rect &dst_rect, double &centre_x, double &centre_y)
     {
-        if ( ! src || ! dst || src->kind != SGDS_Bitmap )
-            return;
-        
-        if ( dst_data_sz != 7 )
-            return;
-        
         // dst_data must be 7 values
         double x         = dst_data[0];
         double y         = dst_data[1];
-        double angle     = dst_data[2];
-        double centre_x  = dst_data[3];
-        double centre_y  = dst_data[4];
         double scale_x   = dst_data[5];
         double scale_y   = dst_data[6];
         
-        if ( src_data_sz != 4)
-            return;
-        
         // src_data must be
         double src_x     = src_data[0];
         double src_y     = src_data[1];
         double src_w     = src_data[2];
         double src_h     = src_data[3];
         
-        // Other locals
-        SDL_Texture *srcT;
-        
         // Create destination rect from scale values
-        SDL_Rect dst_rect = {
+        dst_rect = {
             static_cast<int>(x - (src_w * scale_x / 2.0) + src_w/2.0),
             static_cast<int>(y - (src_h * scale_y / 2.0) + src_h/2.0), //fix the drawing position as scaling broke it
             static_cast<int>(src_w * scale_x),
             static_cast<int>(src_h * scale_y)
         }; //scale bitmap
         
-        SDL_Rect src_rect = {
+        src_rect = {
             static_cast<int>(src_x),
             static_cast<int>(src_y),
             static_cast<int>(src_w),
@@ -1960,27 +3307,90 @@ namespace splashkit_lib
         };
         
         // check if any size is 0... and return if nothing is to be drawn
-        if ( 0 == dst_rect.w || 0 == dst_rect.h || 0 == src_rect.w || 0 == src_rect.h ) return;
+        if ( 0 == dst_rect.w || 0 == dst_rect.h || 0 == src_rect.w || 0 == src_rect.h ) return false;
         
         // Adjust centre to be relative to the bitmap centre rather than top-left
-        centre_x = (centre_x * scale_x) + dst_rect.w / 2.0f;
-        centre_y = (centre_y * scale_y) + dst_rect.h / 2.0f;
+        centre_x = (dst_data[3] * scale_x) + dst_rect.w / 2.0f;
+        centre_y = (dst_data[4] * scale_y) + dst_rect.h / 2.0f;
+        
+        return true;
+    }
+    
+    //
+    // The corners of the destination rectangle rotated around the centre:
+    // top-left, top-right, bottom-left, bottom-right.
+    //
+    static void _sk_rotated_corners(const SDL_Rect &dst_rect, double centre_x, double centre_y, double angle, double corners[8])
+    {
+        double cx = dst_rect.x + centre_x, cy = dst_rect.y + centre_y;
+        double rad = angle * M_PI / 180.0;
+        double cos_a = cos(rad), sin_a = sin(rad);
+        
+        corners[0] = dst_rect.x;                corners[1] = dst_rect.y;
+        corners[2] = dst_rect.x + dst_rect.w;   corners[3] = dst_rect.y;
+        corners[4] = dst_rect.x;                corners[5] = dst_rect.y + dst_rect.h;
+        corners[6] = dst_rect.x + dst_rect.w;   corners[7] = dst_rect.y + dst_rect.h;
+        
+        for (int i = 0; i < 4; i++)
+        {
+            double dx = corners[i * 2] - cx, dy = corners[i * 2 + 1] - cy;
+            corners[i * 2] = cx + dx * cos_a - dy * sin_a;
+            corners[i * 2 + 1] = cy + dx * sin_a + dy * cos_a;
+        }
+    }
+    
+    //x, y is the position to draw the bitmap to. As bitmaps scale around their centre, (x, y) is the top-left of the bitmap IF and ONLY IF scale = 1.
+    //Angle is in degrees, 0 being right way up
+    //Centre is the point to rotate around, relative to the bitmap centre (therefore (0,0) would rotate around the centre point)
+    void sk_draw_bitmap( sk_drawing_surface * src, sk_drawing_surface * dst, double * src_data, int src_data_sz, double * dst_data, int dst_data_sz, sk_renderer_flip flip )
+    {
+        if ( ! src || ! dst || src->kind != SGDS_Bitmap )
+            return;
+        
+        if ( dst_data_sz != 7 || src_data_sz != 4 )
+            return;
+        
+        double angle = dst_data[2];
+        double centre_x, centre_y;
+        SDL_Rect src_rect, dst_rect;
+        
+        if ( ! _sk_bitmap_rects(src_data, dst_data, src_rect, dst_rect, centre_x, centre_y) ) return;
+        
+        // Other locals
+        SDL_Texture *srcT;
+        
+        if ( dst->kind == SGDS_Window )
+        {
+            // Mark the corners, rotated around the centre
+            double corners[8];
+            _sk_rotated_corners(dst_rect, centre_x, centre_y, angle, corners);
+            _sk_mark_dirty_points(dst, corners, 4, 0);
+        }
+        
+        // The source must include anything still queued for it
+        sk_flush_drawing_surface(src);
         
         unsigned int count = _sk_renderer_count(dst);
         
         for (unsigned int i = 0; i < count; i++)
         {
-            SDL_Renderer *renderer = _sk_prepared_renderer(dst, i);
-            
-            // if its a window, dont use the renderer index to get the texture
+            // Get the source texture for the window doing the drawing -- before
+            // preparing the renderer, as this may need to copy it across
+            unsigned int idx;
             if (dst->kind == SGDS_Window)
             {
-                unsigned int idx = static_cast<sk_window_be *>(dst->_data)->idx;
-                
-                srcT = static_cast<sk_bitmap_be *>(src->_data)->texture[ idx ];
+                idx = static_cast<sk_window_be *>(dst->_data)->idx;
             }
             else
-                srcT = static_cast<sk_bitmap_be *>(src->_data)->texture[ i ];
+            {
+                sk_bitmap_be *dst_be = static_cast<sk_bitmap_be *>(dst->_data);
+                _sk_ensure_bitmap_owner(dst_be);
+                idx = dst_be->owner;
+            }
+            
+            srcT = _sk_bitmap_texture(static_cast<sk_bitmap_be *>(src->_data), idx);
+            
+            SDL_Renderer *renderer = _sk_prepared_renderer(dst, i);
             
             //Convert parameters to format SDL_RenderCopyEx expects
             SDL_Point centre = {
@@ -1996,8 +3406,101 @@ namespace splashkit_lib
         }
     }
     
+    //
+    // Draw many copies of the one bitmap as a single batch of textured
+    // triangles. Each quad is placed as sk_draw_bitmap would place it,
+    // including rotating around the same (whole pixel) centre.
+    //
+    // 12 values per quad = the 4 src_data values, the 7 dst_data values,
+    // and the sk_renderer_flip.
+    //
+    void sk_draw_bitmap_quads(sk_drawing_surface *src, sk_drawing_surface *dst, const double *data, int count)
+    {
+        if ( ! src || ! dst || src->kind != SGDS_Bitmap || ! data || count <= 0 )
+            return;
+        
+        // Reused between calls, so repeated batches do not allocate
+        static vector<SDL_Vertex> vertices;
+        static vector<int> indices;
+        
+        vertices.clear();
+        indices.clear();
+        
+        _sk_bounds bounds = { INFINITY, INFINITY, -INFINITY, -INFINITY };
+        SDL_Color white = { 255, 255, 255, 255 };
+        
+        for (int i = 0; i < count; i++)
+        {
+            const double *quad = &data[i * 12];
+            double centre_x, centre_y;
+            SDL_Rect src_rect, dst_rect;
+            
+            if ( ! _sk_bitmap_rects(quad, quad + 4, src_rect, dst_rect, centre_x, centre_y) ) continue;
+            
+            double corners[8];
+            _sk_rotated_corners(dst_rect, static_cast<int>(centre_x), static_cast<int>(centre_y), quad[6], corners);
+            
+            float u0 = static_cast<float>(src_rect.x) / src->width;
+            float v0 = static_cast<float>(src_rect.y) / src->height;
+            float u1 = static_cast<float>(src_rect.x + src_rect.w) / src->width;
+            float v1 = static_cast<float>(src_rect.y + src_rect.h) / src->height;
+            
+            sk_renderer_flip flip = static_cast<sk_renderer_flip>(static_cast<int>(quad[11]));
+            if ( flip == sk_FLIP_HORIZONTAL || flip == sk_FLIP_BOTH ) std::swap(u0, u1);
+            if ( flip == sk_FLIP_VERTICAL || flip == sk_FLIP_BOTH ) std::swap(v0, v1);
+            
+            int first = static_cast<int>(vertices.size());
+            vertices.push_back({ { static_cast<float>(corners[0]), static_cast<float>(corners[1]) }, white, { u0, v0 } });
+            vertices.push_back({ { static_cast<float>(corners[2]), static_cast<float>(corners[3]) }, white, { u1, v0 } });
+            vertices.push_back({ { static_cast<float>(corners[6]), static_cast<float>(corners[7]) }, white, { u1, v1 } });
+            vertices.push_back({ { static_cast<float>(corners[4]), static_cast<float>(corners[5]) }, white, { u0, v1 } });
+            
+            int quad_indices[6] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+            indices.insert(indices.end(), quad_indices, quad_indices + 6);
+            
+            for (int c = 0; c < 4; c++)
+            {
+                _sk_grow_bounds(bounds, corners[c * 2], corners[c * 2 + 1], corners[c * 2], corners[c * 2 + 1]);
+            }
+        }
+        
+        if ( indices.empty() ) return;
+        
+        _sk_mark_dirty(dst, bounds.min_x, bounds.min_y, bounds.max_x - bounds.min_x, bounds.max_y - bounds.min_y);
+        
+        // The source must include anything still queued for it
+        sk_flush_drawing_surface(src);
+        
+        unsigned int renderers = _sk_renderer_count(dst);
+        
+        for (unsigned int i = 0; i < renderers; i++)
+        {
+            unsigned int idx;
+            if (dst->kind == SGDS_Window)
+            {
+                idx = static_cast<sk_window_be *>(dst->_data)->idx;
+            }
+            else
+            {
+                sk_bitmap_be *dst_be = static_cast<sk_bitmap_be *>(dst->_data);
+                _sk_ensure_bitmap_owner(dst_be);
+                idx = dst_be->owner;
+            }
+            
+            SDL_Texture *srcT = _sk_bitmap_texture(static_cast<sk_bitmap_be *>(src->_data), idx);
+            SDL_Renderer *renderer = _sk_prepared_renderer(dst, i);
+            
+            SDL_RenderGeometry(renderer, srcT, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size()));
+            
+            _sk_complete_render(dst, i);
+        }
+    }
+    
     void sk_finalise_graphics()
     {
+        // Finish writing any pngs
+        _sk_stop_png_workers();
+        
         // Close all bitmaps
         for (unsigned int i = _sk_num_open_bitmaps; i > 0; i--)
         {
@@ -15,16 +15,64 @@
 #include <SDL.h>
 #endif
 
+#include <future>
+
 #include "backend_types.h"
 namespace splashkit_lib
 {
     typedef unsigned int uint;
 
+    //
+    // Geometry queued for a surface while deferred drawing is enabled.
+    // Everything in here is drawn with one SDL_RenderGeometry call per
+    // renderer when the surface is flushed.
+    //
+    struct sk_geometry_batch
+    {
+        vector<SDL_Vertex>  vertices;
+        vector<int>         indices;
+    };
+
+    //
+    // What a renderer is currently set to, so the SDL calls can be skipped
+    // when the state does not change. Unknown values are re-sent.
+    //
+    struct sk_render_state
+    {
+        bool            target_known;
+        SDL_Texture *   target;
+        SDL_BlendMode   blend;          // SDL_BLENDMODE_INVALID when unknown
+        bool            color_known;
+        SDL_Color       color;
+        bool            clip_known;
+        bool            clipped;
+        SDL_Rect        clip;
+    };
+
+    //
+    // CPU copy of a window or bitmap's pixels (RGBA8888, one int per pixel),
+    // used by sk_lock_pixels. It is current while its version matches the
+    // surface's version, which moves on with every draw.
+    //
+    struct sk_pixel_shadow
+    {
+        int *           pixels;     // or nullptr if never locked
+        int             width, height;
+        unsigned int    version;
+        bool            locked;
+
+        // Single pixel reads at read_version, so that many reads
+        // without drawing in between can read all of the pixels once
+        unsigned int    reads;
+        unsigned int    read_version;
+    };
+
     struct sk_window_be
     {
         SDL_Window *    window;
         SDL_Renderer *  renderer;
         SDL_Texture *   backing;
+        SDL_Surface *   canvas;     // headless windows draw into this instead of an SDL_Window
         bool            clipped;
         SDL_Rect        clip;
         unsigned int    idx;
@@ -32,17 +80,42 @@ namespace splashkit_lib
         // Event data store
         sk_window_data  event_data;
         sk_drawing_surface *surface;
+
+        // Deferred drawing waiting to be flushed (or nullptr)
+        sk_geometry_batch *pending;
+
+        // Cached state of the renderer
+        sk_render_state state;
+
+        // Incremented by each draw onto the backing texture
+        unsigned int    version;
+        sk_pixel_shadow shadow;
+
+        // Partial presents are skipped when nothing has been drawn since the
+        // last present. An empty dirty rect means nothing was drawn.
+        bool            partial_present;
+        SDL_Rect        dirty;
     };
 
     struct sk_bitmap_be
     {
-        // 1 texture per open window
+        // 1 texture slot per open window. The owner's texture is the real
+        // bitmap, other windows get a copy when they draw it, which is
+        // refreshed once the bitmap's version moves past the copy's.
         SDL_Texture **  texture;
+        unsigned int *  texture_version;
+        unsigned int    version;    // incremented by each draw onto the bitmap
+        unsigned int    owner;      // window index, UINT_MAX when there is no texture
         SDL_Surface *   surface;
         bool            clipped;
         SDL_Rect        clip;
 
         bool            drawable; // can be drawn on
+
+        // Deferred drawing waiting to be flushed (or nullptr)
+        sk_geometry_batch *pending;
+
+        sk_pixel_shadow shadow;
     };
 
     sk_drawing_surface sk_open_window(const char *title, int width, int height);
@@ -51,8 +124,23 @@ namespace splashkit_lib
 
     sk_drawing_surface sk_load_bitmap(const char * filename);
 
+    // Decoded image pixels, not yet a bitmap. Decoding can run on worker threads.
+    struct sk_decoded_bitmap
+    {
+        int width;
+        int height;
+        void * _data;
+    };
+
+    void sk_init_image_decoding();
+    sk_decoded_bitmap sk_decode_bitmap(const char * filename);
+    const int * sk_decoded_pixels(sk_decoded_bitmap *image);
+    void sk_free_decoded_bitmap(sk_decoded_bitmap *image);
+    sk_drawing_surface sk_load_decoded_bitmap(sk_decoded_bitmap *image);
+
 
     void sk_draw_bitmap( sk_drawing_surface * src, sk_drawing_surface * dst, double * src_data, int src_data_sz, double * dst_data, int dst_data_sz, sk_renderer_flip flip );
+    void sk_draw_bitmap_quads(sk_drawing_surface *src, sk_drawing_surface *dst, const double *data, int count);
 
     void sk_set_icon(sk_drawing_surface *surface, sk_drawing_surface *icon);
 
@@ -75,11 +163,18 @@ namespace splashkit_lib
     void sk_draw_pixel(sk_drawing_surface *surface, sk_color clr, double x, double y);
     sk_color sk_read_pixel(sk_drawing_surface *surface, int x, int y);
 
+    int * sk_lock_pixels(sk_drawing_surface *surface, int *pitch);
+    void sk_unlock_pixels(sk_drawing_surface *surface, bool changed);
+
     void sk_draw_circle(sk_drawing_surface *surface, sk_color clr, double x, double y, double radius);
     void sk_fill_circle(sk_drawing_surface *surface, sk_color clr, double x, double y, double radius);
 
     void sk_draw_line(sk_drawing_surface *surface, sk_color clr, double x1, double y1, double x2, double y2, double size);
 
+    void sk_fill_rects(sk_drawing_surface *surface, const sk_color *clrs, const double *data, int count);
+    void sk_fill_circles(sk_drawing_surface *surface, const sk_color *clrs, const double *data, int count);
+    void sk_draw_lines(sk_drawing_surface *surface, const sk_color *clrs, const double *data, int count, double size);
+
     void sk_set_clip_rect(sk_drawing_surface *surface, double x, double y, double width, double height);
     void sk_clear_clip_rect(sk_drawing_surface *surface);
 
@@ -92,6 +187,20 @@ namespace splashkit_lib
     void sk_resize(sk_drawing_surface *surface, int width, int height);
 
     int sk_save_png(sk_drawing_surface * surface, const char *filename);
+    std::shared_future<bool> sk_save_png_async(sk_drawing_surface * surface, const char *filename);
+    unsigned int sk_png_saves_pending();
+    void sk_wait_for_png_saves();
+
+    // Finish the pending png saves and join the workers, run at exit
+    void _sk_stop_png_workers();
+
+    void sk_set_partial_present(sk_drawing_surface *window, bool partial);
+    bool sk_partial_present(sk_drawing_surface *window);
+
+    void sk_set_deferred_drawing(bool deferred);
+    bool sk_deferred_drawing();
+    void sk_flush_drawing_surface(sk_drawing_surface *surface);
+    void sk_flush_all_drawing();
 
     struct sk_window_be;
 
@@ -102,6 +211,11 @@ namespace splashkit_lib
     unsigned int _sk_renderer_count(sk_drawing_surface *surface);
     SDL_Renderer * _sk_prepared_renderer(sk_drawing_surface *surface, unsigned int idx);
     void _sk_complete_render(sk_drawing_surface *surface, unsigned int idx);
+    void _sk_set_draw_color(SDL_Renderer *renderer, sk_color clr);
+    void _sk_forget_draw_state(SDL_Renderer *renderer);
+    void _sk_mark_dirty(sk_drawing_surface *surface, double x, double y, double width, double height);
+    void _sk_mark_window_dirty(sk_window_be *window_be);
+    int _sk_renderer_window_index(SDL_Renderer *renderer);
 }
 
 #endif /* defined(graphics_driver) */
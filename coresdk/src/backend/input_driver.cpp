@@ -469,6 +469,7 @@ namespace splashkit_lib
         {
             case SDL_WINDOWEVENT_SHOWN:
                 window->event_data.shown = true;
+                _sk_mark_window_dirty(window);
                 //SDL_Log("Window %d shown", event->window.windowID);
                 break;
             case SDL_WINDOWEVENT_HIDDEN:
@@ -476,6 +477,8 @@ namespace splashkit_lib
                 //            SDL_Log("Window %d hidden", event->window.windowID);
                 break;
             case SDL_WINDOWEVENT_EXPOSED:
+                // all of the window needs to be shown again
+                _sk_mark_window_dirty(window);
                 //            SDL_Log("Window %d exposed", event->window.windowID);
                 break;
             case SDL_WINDOWEVENT_MOVED:
@@ -502,6 +505,7 @@ namespace splashkit_lib
                 //            SDL_Log("Window %d maximized", event->window.windowID);
                 break;
             case SDL_WINDOWEVENT_RESTORED:
+                _sk_mark_window_dirty(window);
                 //            SDL_Log("Window %d restored", event->window.windowID);
                 break;
             case SDL_WINDOWEVENT_ENTER:
@@ -689,7 +693,7 @@ namespace splashkit_lib
                 sk_window_be * window_be;
                 window_be = static_cast<sk_window_be *>(surface->_data);
                 
-                SDL_WarpMouseInWindow(window_be->window, x, y);
+                if ( window_be->window ) SDL_WarpMouseInWindow(window_be->window, x, y);
                 break;
             }
                 
@@ -718,7 +722,16 @@ namespace splashkit_lib
                 sk_window_be * window_be;
                 window_be = static_cast<sk_window_be *>(surface->_data);
                 
-                SDL_GetWindowPosition(window_be->window, x, y);
+                if ( window_be->window )
+                {
+                    SDL_GetWindowPosition(window_be->window, x, y);
+                }
+                else
+                {
+                    // headless windows are not on any screen
+                    *x = 0;
+                    *y = 0;
+                }
                 break;
             }
                 
@@ -762,7 +775,7 @@ namespace splashkit_lib
                 sk_window_be * window_be;
                 window_be = static_cast<sk_window_be *>(surface->_data);
                 
-                SDL_SetWindowPosition(window_be->window, x, y);
+                if ( window_be->window ) SDL_SetWindowPosition(window_be->window, x, y);
                 
                 return;
             }
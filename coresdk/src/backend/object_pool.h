@@ -0,0 +1,152 @@
+//
+//  object_pool.h
+//  splashkit
+//
+//  Copyright © 2016 Andrew Cain. All rights reserved.
+//
+
+#ifndef splashkit_object_pool_h
+#define splashkit_object_pool_h
+
+#include "types.h"
+#include "backend_types.h"
+
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace splashkit_lib
+{
+    /**
+     * A typed pool for the core handle types. Objects are carved out of
+     * slabs that are kept for the life of the pool. Released slots go on a
+     * freelist and are handed out, oldest first, before any fresh slot.
+     *
+     * T must have a `pointer_identifier id` field. When an object is
+     * released its slot is left holding `NONE_PTR`, so a stale handle still
+     * fails `VALID_PTR` until the slot is reused. A slot is only reused once
+     * QUARANTINE more slots have been released after it, so a handle freed
+     * and then used again a moment later (such as from a queued event) is
+     * still caught rather than landing on a new object.
+     *
+     * The pool is locked internally, so objects can be allocated and
+     * released from any thread.
+     */
+    template <typename T, unsigned int SLAB_SIZE = 64, unsigned int QUARANTINE = 16>
+    class object_pool
+    {
+    private:
+        std::mutex _mutex;
+        std::vector<T *> _slabs;
+        std::deque<T *> _free;
+        pool_statistics _stats = {};
+
+        T *_fresh = nullptr;        // next never-used slot in the newest slab
+        unsigned int _fresh_left = 0;
+
+        void add_slab()
+        {
+            T *slab = static_cast<T *>(std::malloc(sizeof(T) * SLAB_SIZE));
+            if (not slab) throw std::bad_alloc();
+
+            _slabs.push_back(slab);
+            _stats.capacity += SLAB_SIZE;
+            _fresh = slab;
+            _fresh_left = SLAB_SIZE;
+        }
+
+        T *take_slot()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            T *result;
+
+            if (_free.size() > QUARANTINE)
+            {
+                result = _free.front();
+                _free.pop_front();
+                _stats.reuses++;
+            }
+            else
+            {
+                if (_fresh_left == 0) add_slab();
+                result = _fresh++;
+                _fresh_left--;
+            }
+
+            _stats.allocations++;
+            _stats.in_use++;
+            if (_stats.in_use > _stats.peak_in_use)
+                _stats.peak_in_use = _stats.in_use;
+
+            return result;
+        }
+
+        void return_slot(T *obj)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _free.push_back(obj);
+            _stats.in_use--;
+            _stats.releases++;
+        }
+
+    public:
+        object_pool() = default;
+        object_pool(const object_pool &) = delete;
+        object_pool &operator=(const object_pool &) = delete;
+
+        ~object_pool()
+        {
+            // Objects still in use at exit are left alone, as other static
+            // cleanup may yet refer to them.
+            if (_stats.in_use > 0) return;
+
+            for (T *slab : _slabs)
+            {
+                std::free(slab);
+            }
+        }
+
+        // Constructs a new T in a pooled slot, passing args to its
+        // constructor.
+        template <typename... Args>
+        T *allocate(Args &&... args)
+        {
+            T *slot = take_slot();
+
+            try
+            {
+                return new (slot) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                new (&slot->id) pointer_identifier(NONE_PTR);
+                return_slot(slot);
+                throw;
+            }
+        }
+
+        // Destroys obj and returns its slot to the pool. The slot keeps
+        // NONE_PTR as its id until it is handed out again.
+        void release(T *obj)
+        {
+            if (not obj) return;
+
+            pointer_identifier *id = &obj->id;
+            obj->~T();
+            new (id) pointer_identifier(NONE_PTR);
+
+            return_slot(obj);
+        }
+
+        pool_statistics statistics()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _stats;
+        }
+    };
+}
+
+#endif /* splashkit_object_pool_h */
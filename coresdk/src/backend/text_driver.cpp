@@ -23,6 +23,10 @@
 #include "core_driver.h"
 #include "utility_functions.h"
 
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+
 using std::cerr;
 using std::endl;
 
@@ -59,6 +63,645 @@ namespace splashkit_lib
         TTF_Quit();
     }
 
+    //--------------------------------------------------------------------------------------
+    //
+    // Glyph atlas
+    //
+    //--------------------------------------------------------------------------------------
+
+    // Glyphs are rendered once into an atlas for each font size and style.
+    // Text is then drawn as a batch of quads from the atlas, tinted by vertex
+    // colour so that changing colour does not render the glyphs again.
+    #define GLYPH_ATLAS_WIDTH 512
+    #define GLYPH_ATLAS_MAX_HEIGHT 2048
+    #define GLYPH_ATLAS_MAX_FONT_SIZE 128   // larger text is rendered as a whole string
+
+    struct _sk_glyph
+    {
+        SDL_Rect    rect;       // Where the glyph is in the atlas, w is 0 for blank glyphs
+        int         advance;    // How far the pen moves on after this glyph
+    };
+
+    struct _sk_glyph_atlas
+    {
+        SDL_Surface *   pixels;                 // White glyphs with coverage in the alpha
+        unsigned int    version;                // Incremented as glyphs are added
+        int             pen_x, pen_y, row_height;
+        bool            full;                   // Cleared before the next draw
+        std::unordered_map<Uint16, _sk_glyph> glyphs;
+
+        // A texture for each window, uploaded from pixels when out of date
+        vector<SDL_Texture *>   textures;
+        vector<unsigned int>    texture_versions;
+    };
+
+    // Keyed by the font at a size, and the style it was rendered with
+    static map<std::pair<TTF_Font *, int>, _sk_glyph_atlas *> _glyph_atlases;
+
+    static void _sk_destroy_glyph_textures(_sk_glyph_atlas *atlas)
+    {
+        for (SDL_Texture *tex : atlas->textures)
+        {
+            if (tex) SDL_DestroyTexture(tex);
+        }
+
+        atlas->textures.clear();
+        atlas->texture_versions.clear();
+    }
+
+    static void _sk_clear_glyph_atlas(_sk_glyph_atlas *atlas)
+    {
+        SDL_FillRect(atlas->pixels, nullptr, 0);
+        atlas->glyphs.clear();
+        atlas->pen_x = 0;
+        atlas->pen_y = 0;
+        atlas->row_height = 0;
+        atlas->full = false;
+        atlas->version++;
+    }
+
+    static _sk_glyph_atlas *_sk_get_glyph_atlas(TTF_Font *ttf_font)
+    {
+        auto key = std::make_pair(ttf_font, TTF_GetFontStyle(ttf_font));
+
+        auto it = _glyph_atlases.find(key);
+        if (it != _glyph_atlases.end()) return it->second;
+
+        SDL_Surface *pixels = SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, 256, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!pixels) return nullptr;
+
+        _sk_glyph_atlas *atlas = new _sk_glyph_atlas;
+        atlas->pixels = pixels;
+        atlas->version = 0;
+        _sk_clear_glyph_atlas(atlas);
+
+        _glyph_atlases[key] = atlas;
+        return atlas;
+    }
+
+    //
+    // Free the atlases for all styles of this font size, before it is closed
+    //
+    static void _sk_free_glyph_atlases(TTF_Font *ttf_font)
+    {
+        for (auto it = _glyph_atlases.begin(); it != _glyph_atlases.end(); )
+        {
+            if (it->first.first == ttf_font)
+            {
+                _sk_destroy_glyph_textures(it->second);
+                SDL_FreeSurface(it->second->pixels);
+                delete it->second;
+                it = _glyph_atlases.erase(it);
+            }
+            else
+                it++;
+        }
+    }
+
+    //
+    // Double the height of the atlas until it can fit height rows of pixels
+    //
+    static bool _sk_grow_glyph_atlas(_sk_glyph_atlas *atlas, int height)
+    {
+        int new_height = atlas->pixels->h;
+        while (new_height < height) new_height *= 2;
+
+        if (new_height > GLYPH_ATLAS_MAX_HEIGHT) return false;
+
+        SDL_Surface *pixels = SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, new_height, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!pixels) return false;
+
+        SDL_FillRect(pixels, nullptr, 0);
+        SDL_SetSurfaceBlendMode(atlas->pixels, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(atlas->pixels, nullptr, pixels, nullptr);
+        SDL_FreeSurface(atlas->pixels);
+
+        atlas->pixels = pixels;
+        atlas->version++;
+
+        // The textures are now the wrong size
+        _sk_destroy_glyph_textures(atlas);
+        return true;
+    }
+
+    //
+    // Find the glyph in the atlas, rendering it in if this is its first use.
+    // utf8 points to the len bytes that encode the glyph. Returns nullptr
+    // when the atlas is full.
+    //
+    static const _sk_glyph *_sk_atlas_glyph(_sk_glyph_atlas *atlas, TTF_Font *ttf_font, Uint16 ch, const char *utf8, int len)
+    {
+        auto it = atlas->glyphs.find(ch);
+        if (it != atlas->glyphs.end()) return &it->second;
+
+        _sk_glyph glyph = { { 0, 0, 0, 0 }, 0 };
+        int min_x, max_x, min_y, max_y;
+
+        if (TTF_GlyphMetrics(ttf_font, ch, &min_x, &max_x, &min_y, &max_y, &glyph.advance) != 0)
+            glyph.advance = 0;
+
+        // Rendering the glyph as text places it on the baseline, as it will
+        // be when drawn as part of a string
+        SDL_Color white = { 255, 255, 255, 255 };
+        SDL_Surface *rendered = TTF_RenderUTF8_Blended(ttf_font, string(utf8, len).c_str(), white);
+
+        if (rendered)
+        {
+            int w = rendered->w, h = rendered->h;
+
+            if (atlas->pen_x + w > GLYPH_ATLAS_WIDTH)
+            {
+                atlas->pen_x = 0;
+                atlas->pen_y += atlas->row_height;
+                atlas->row_height = 0;
+            }
+
+            if (w > GLYPH_ATLAS_WIDTH or (atlas->pen_y + h > atlas->pixels->h and not _sk_grow_glyph_atlas(atlas, atlas->pen_y + h)))
+            {
+                SDL_FreeSurface(rendered);
+                atlas->full = true;
+                return nullptr;
+            }
+
+            glyph.rect = { atlas->pen_x, atlas->pen_y, w, h };
+
+            SDL_SetSurfaceBlendMode(rendered, SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(rendered, nullptr, atlas->pixels, &glyph.rect);
+            SDL_FreeSurface(rendered);
+
+            // Leave a pixel between glyphs so they do not bleed when scaled
+            atlas->pen_x += w + 1;
+            if (h + 1 > atlas->row_height) atlas->row_height = h + 1;
+            atlas->version++;
+        }
+
+        return &(atlas->glyphs[ch] = glyph);
+    }
+
+    //
+    // Get the atlas texture for the renderer, uploading any glyphs added
+    // since it was last used
+    //
+    static SDL_Texture *_sk_glyph_texture(_sk_glyph_atlas *atlas, SDL_Renderer *renderer)
+    {
+        int idx = _sk_renderer_window_index(renderer);
+        if (idx < 0) return nullptr;
+
+        if (idx >= atlas->textures.size())
+        {
+            atlas->textures.resize(idx + 1, nullptr);
+            atlas->texture_versions.resize(idx + 1, 0);
+        }
+
+        SDL_Texture *&tex = atlas->textures[idx];
+
+        if (!tex)
+        {
+            tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, atlas->pixels->w, atlas->pixels->h);
+            if (!tex) return nullptr;
+
+            SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+            atlas->texture_versions[idx] = atlas->version - 1;
+        }
+
+        if (atlas->texture_versions[idx] != atlas->version)
+        {
+            SDL_UpdateTexture(tex, nullptr, atlas->pixels->pixels, atlas->pixels->pitch);
+            atlas->texture_versions[idx] = atlas->version;
+        }
+
+        return tex;
+    }
+
+    //
+    // Decode the UTF-8 character at text into cp, returning the number of
+    // bytes used, or 0 if the encoding is invalid
+    //
+    static int _sk_utf8_decode(const char *text, Uint32 &cp)
+    {
+        const unsigned char *s = reinterpret_cast<const unsigned char *>(text);
+        int len;
+
+        if (s[0] < 0x80)            { cp = s[0]; return 1; }
+        else if (s[0] >> 5 == 0x6)  { cp = s[0] & 0x1f; len = 2; }
+        else if (s[0] >> 4 == 0xe)  { cp = s[0] & 0x0f; len = 3; }
+        else if (s[0] >> 3 == 0x1e) { cp = s[0] & 0x07; len = 4; }
+        else return 0;
+
+        for (int i = 1; i < len; i++)
+        {
+            if (s[i] >> 6 != 0x2) return 0;
+            cp = (cp << 6) | (s[i] & 0x3f);
+        }
+
+        return len;
+    }
+
+    //
+    // Draw the text from the font's glyph atlas. Returns false if the text
+    // can not be drawn this way, so it needs to be rendered as a whole.
+    //
+    static bool _sk_draw_atlas_text(sk_drawing_surface *surface, TTF_Font *ttf_font, int font_size, double x, double y, const char *text, sk_color clr)
+    {
+        if (font_size > GLYPH_ATLAS_MAX_FONT_SIZE) return false;
+
+        // Lines through the text would be broken between glyphs
+        if (TTF_GetFontStyle(ttf_font) & (TTF_STYLE_UNDERLINE | TTF_STYLE_STRIKETHROUGH)) return false;
+
+        _sk_glyph_atlas *atlas = _sk_get_glyph_atlas(ttf_font);
+        if (!atlas) return false;
+
+        if (atlas->full) _sk_clear_glyph_atlas(atlas);
+
+        // Reused between calls, so repeated text does not allocate
+        static vector<SDL_Vertex> vertices;
+        static vector<int> indices;
+
+        vertices.clear();
+        indices.clear();
+
+        SDL_Color color;
+        color.r = static_cast<Uint8>(clr.r * 255);
+        color.g = static_cast<Uint8>(clr.g * 255);
+        color.b = static_cast<Uint8>(clr.b * 255);
+        color.a = static_cast<Uint8>(clr.a * 255);
+
+        bool kerning = TTF_GetFontKerning(ttf_font) != 0;
+        float left = static_cast<int>(x), top = static_cast<int>(y);
+        int pen = 0, right = 0;
+        Uint16 prev = 0;
+
+        for (const char *p = text; *p; )
+        {
+            Uint32 cp;
+            int len = _sk_utf8_decode(p, cp);
+            if (len == 0 or cp > 0xffff) return false;
+
+            Uint16 ch = static_cast<Uint16>(cp);
+            if (kerning and prev) pen += TTF_GetFontKerningSizeGlyphs(ttf_font, prev, ch);
+
+            const _sk_glyph *glyph = _sk_atlas_glyph(atlas, ttf_font, ch, p, len);
+            if (!glyph) return false;
+
+            const SDL_Rect &r = glyph->rect;
+            if (r.w > 0)
+            {
+                // Texture coordinates are in pixels until the atlas stops growing
+                float x0 = left + pen, y0 = top, x1 = x0 + r.w, y1 = y0 + r.h;
+                float u0 = r.x, v0 = r.y, u1 = r.x + r.w, v1 = r.y + r.h;
+
+                int first = static_cast<int>(vertices.size());
+                vertices.push_back({ { x0, y0 }, color, { u0, v0 } });
+                vertices.push_back({ { x1, y0 }, color, { u1, v0 } });
+                vertices.push_back({ { x1, y1 }, color, { u1, v1 } });
+                vertices.push_back({ { x0, y1 }, color, { u0, v1 } });
+
+                int quad_indices[6] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+                indices.insert(indices.end(), quad_indices, quad_indices + 6);
+
+                if (pen + r.w > right) right = pen + r.w;
+            }
+
+            pen += glyph->advance;
+            prev = ch;
+            p += len;
+        }
+
+        if (indices.empty()) return true;
+
+        float atlas_w = atlas->pixels->w, atlas_h = atlas->pixels->h;
+        for (SDL_Vertex &v : vertices)
+        {
+            v.tex_coord.x /= atlas_w;
+            v.tex_coord.y /= atlas_h;
+        }
+
+        _sk_mark_dirty(surface, left, top, right, TTF_FontHeight(ttf_font));
+
+        unsigned int count = _sk_renderer_count(surface);
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            SDL_Renderer *renderer = _sk_prepared_renderer(surface, i);
+            SDL_Texture *tex = _sk_glyph_texture(atlas, renderer);
+
+            if (tex)
+                SDL_RenderGeometry(renderer, tex, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size()));
+
+            _sk_complete_render(surface, i);
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------------
+    //
+    // Text cache
+    //
+    //--------------------------------------------------------------------------------------
+
+    // When enabled, whole strings are rendered once to a texture and kept in
+    // a least recently used cache, so drawing the same label again is a
+    // single copy.
+    #define TEXT_CACHE_DEFAULT_BUDGET (8 * 1024 * 1024)
+
+    struct _sk_text_key
+    {
+        string      text;
+        TTF_Font *  font;       // the font at a given size
+        int         style;
+        Uint32      rgba;
+
+        bool operator==(const _sk_text_key &other) const
+        {
+            return font == other.font and style == other.style and rgba == other.rgba and text == other.text;
+        }
+    };
+
+    struct _sk_text_key_hash
+    {
+        size_t operator()(const _sk_text_key &key) const
+        {
+            size_t result = std::hash<string>()(key.text);
+            result ^= std::hash<void *>()(key.font) + 0x9e3779b9 + (result << 6) + (result >> 2);
+            result ^= std::hash<Uint32>()(key.rgba ^ (static_cast<Uint32>(key.style) << 24)) + 0x9e3779b9 + (result << 6) + (result >> 2);
+            return result;
+        }
+    };
+
+    struct _sk_cached_text
+    {
+        _sk_text_key            key;
+        int                     w, h;
+        vector<SDL_Texture *>   textures;   // one for each window that has drawn it
+        size_t                  bytes;
+    };
+
+    // Most recently used at the front
+    static std::list<_sk_cached_text> _text_cache;
+    static std::unordered_map<_sk_text_key, std::list<_sk_cached_text>::iterator, _sk_text_key_hash> _text_cache_index;
+    static bool _text_cache_enabled = false;
+    static size_t _text_cache_budget = TEXT_CACHE_DEFAULT_BUDGET;
+    static size_t _text_cache_bytes = 0;
+    static text_cache_statistics _text_cache_stats = {};
+
+    static void _sk_evict_cached_text(std::list<_sk_cached_text>::iterator it)
+    {
+        for (SDL_Texture *tex : it->textures)
+        {
+            if (tex) SDL_DestroyTexture(tex);
+        }
+
+        _text_cache_bytes -= it->bytes;
+        _text_cache_index.erase(it->key);
+        _text_cache.erase(it);
+    }
+
+    static void _sk_trim_text_cache()
+    {
+        while (_text_cache_bytes > _text_cache_budget and not _text_cache.empty())
+        {
+            _sk_evict_cached_text(std::prev(_text_cache.end()));
+            _text_cache_stats.evictions++;
+        }
+    }
+
+    //
+    // Remove the cached text for this font size, before it is closed
+    //
+    static void _sk_free_cached_text(TTF_Font *ttf_font)
+    {
+        for (auto it = _text_cache.begin(); it != _text_cache.end(); )
+        {
+            auto next = std::next(it);
+            if (it->key.font == ttf_font) _sk_evict_cached_text(it);
+            it = next;
+        }
+    }
+
+    void sk_set_text_cache(bool enabled)
+    {
+        _text_cache_enabled = enabled;
+    }
+
+    bool sk_text_cache_enabled()
+    {
+        return _text_cache_enabled;
+    }
+
+    void sk_set_text_cache_budget(size_t bytes)
+    {
+        _text_cache_budget = bytes;
+        _sk_trim_text_cache();
+    }
+
+    size_t sk_text_cache_budget()
+    {
+        return _text_cache_budget;
+    }
+
+    void sk_clear_text_cache()
+    {
+        while (not _text_cache.empty())
+        {
+            _sk_evict_cached_text(_text_cache.begin());
+        }
+    }
+
+    text_cache_statistics sk_text_cache_statistics()
+    {
+        text_cache_statistics result = _text_cache_stats;
+        result.entries = static_cast<int>(_text_cache.size());
+        result.bytes = static_cast<int>(_text_cache_bytes);
+        return result;
+    }
+
+    void sk_reset_text_cache_statistics()
+    {
+        _text_cache_stats = {};
+    }
+
+    //
+    // Draw the text from its cached texture, rendering and caching it if
+    // this window has not drawn it recently
+    //
+    static void _sk_draw_cached_text(sk_drawing_surface *surface, TTF_Font *ttf_font, double x, double y, const char *text, const SDL_Color &color)
+    {
+        _sk_text_key key = { text, ttf_font, TTF_GetFontStyle(ttf_font), static_cast<Uint32>(color.r << 24 | color.g << 16 | color.b << 8 | color.a) };
+
+        auto found = _text_cache_index.find(key);
+        std::list<_sk_cached_text>::iterator entry;
+
+        if (found != _text_cache_index.end())
+        {
+            entry = found->second;
+            _text_cache.splice(_text_cache.begin(), _text_cache, entry);
+        }
+        else
+        {
+            _text_cache.push_front({ key, 0, 0, {}, 0 });
+            entry = _text_cache.begin();
+            _text_cache_index[key] = entry;
+        }
+
+        unsigned int count = _sk_renderer_count(surface);
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            SDL_Renderer *renderer = _sk_prepared_renderer(surface, i);
+            int idx = _sk_renderer_window_index(renderer);
+            if (idx < 0) continue;
+
+            if (idx >= entry->textures.size()) entry->textures.resize(idx + 1, nullptr);
+            SDL_Texture *&tex = entry->textures[idx];
+
+            if (tex)
+            {
+                _text_cache_stats.hits++;
+            }
+            else
+            {
+                _text_cache_stats.misses++;
+
+                SDL_Surface *text_surface = TTF_RenderUTF8_Blended(ttf_font, text, color);
+                if (!text_surface) continue;
+
+                tex = SDL_CreateTextureFromSurface(renderer, text_surface);
+                entry->w = text_surface->w;
+                entry->h = text_surface->h;
+                SDL_FreeSurface(text_surface);
+
+                if (!tex) continue;
+
+                size_t bytes = static_cast<size_t>(entry->w) * entry->h * 4;
+                entry->bytes += bytes;
+                _text_cache_bytes += bytes;
+            }
+
+            SDL_Rect rect = { static_cast<int>(x), static_cast<int>(y), entry->w, entry->h };
+            SDL_RenderCopy(renderer, tex, nullptr, &rect);
+
+            _sk_complete_render(surface, i);
+        }
+
+        _sk_mark_dirty(surface, x, y, entry->w, entry->h);
+
+        // Do not keep entries for text that failed to render
+        if (entry->bytes == 0) _sk_evict_cached_text(entry);
+
+        _sk_trim_text_cache();
+    }
+
+    void _sk_remove_text_textures(unsigned int window_idx)
+    {
+        for (auto &it : _glyph_atlases)
+        {
+            _sk_glyph_atlas *atlas = it.second;
+            if (window_idx >= atlas->textures.size()) continue;
+
+            if (atlas->textures[window_idx]) SDL_DestroyTexture(atlas->textures[window_idx]);
+            atlas->textures.erase(atlas->textures.begin() + window_idx);
+            atlas->texture_versions.erase(atlas->texture_versions.begin() + window_idx);
+        }
+
+        for (auto it = _text_cache.begin(); it != _text_cache.end(); )
+        {
+            auto next = std::next(it);
+            _sk_cached_text &cached = *it;
+
+            if (window_idx < cached.textures.size())
+            {
+                SDL_Texture *tex = cached.textures[window_idx];
+                if (tex)
+                {
+                    size_t bytes = static_cast<size_t>(cached.w) * cached.h * 4;
+                    cached.bytes -= bytes;
+                    _text_cache_bytes -= bytes;
+                    SDL_DestroyTexture(tex);
+                }
+
+                cached.textures.erase(cached.textures.begin() + window_idx);
+
+                // Only drawn to the closed window, so nothing is left to reuse
+                if (cached.bytes == 0) _sk_evict_cached_text(it);
+            }
+
+            it = next;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    //
+    // Text measurement
+    //
+    //--------------------------------------------------------------------------------------
+
+    // Sizes of recently measured strings, and the advance of each glyph, for
+    // a font size and style. The size cache is emptied once it is full.
+    #define TEXT_SIZE_CACHE_LIMIT 2048
+
+    struct _sk_font_metrics
+    {
+        int                                 ascii_advances[128];    // -1 until measured
+        std::unordered_map<Uint16, int>     advances;
+        std::unordered_map<string, std::pair<int, int>> sizes;
+    };
+
+    static map<std::pair<TTF_Font *, int>, _sk_font_metrics *> _font_metrics;
+
+    static _sk_font_metrics *_sk_get_font_metrics(TTF_Font *ttf_font)
+    {
+        auto key = std::make_pair(ttf_font, TTF_GetFontStyle(ttf_font));
+
+        auto it = _font_metrics.find(key);
+        if (it != _font_metrics.end()) return it->second;
+
+        _sk_font_metrics *metrics = new _sk_font_metrics;
+        std::fill(metrics->ascii_advances, metrics->ascii_advances + 128, -1);
+
+        _font_metrics[key] = metrics;
+        return metrics;
+    }
+
+    //
+    // Free the metrics for all styles of this font size, before it is closed
+    //
+    static void _sk_free_font_metrics(TTF_Font *ttf_font)
+    {
+        for (auto it = _font_metrics.begin(); it != _font_metrics.end(); )
+        {
+            if (it->first.first == ttf_font)
+            {
+                delete it->second;
+                it = _font_metrics.erase(it);
+            }
+            else
+                it++;
+        }
+    }
+
+    static int _sk_glyph_advance(_sk_font_metrics *metrics, TTF_Font *ttf_font, Uint16 ch)
+    {
+        if (ch < 128 and metrics->ascii_advances[ch] >= 0) return metrics->ascii_advances[ch];
+
+        if (ch >= 128)
+        {
+            auto it = metrics->advances.find(ch);
+            if (it != metrics->advances.end()) return it->second;
+        }
+
+        int min_x, max_x, min_y, max_y, advance;
+        if (TTF_GlyphMetrics(ttf_font, ch, &min_x, &max_x, &min_y, &max_y, &advance) != 0)
+            advance = 0;
+
+        if (ch < 128)
+            metrics->ascii_advances[ch] = advance;
+        else
+            metrics->advances[ch] = advance;
+
+        return advance;
+    }
+
     sk_font_data* sk_load_font(const char * filename, int font_size)
     {
         internal_sk_init();
@@ -150,6 +793,9 @@ namespace splashkit_lib
             {
                 if (it.second)
                 {
+                    _sk_free_glyph_atlases(static_cast<TTF_Font *>(it.second));
+                    _sk_free_cached_text(static_cast<TTF_Font *>(it.second));
+                    _sk_free_font_metrics(static_cast<TTF_Font *>(it.second));
                     TTF_CloseFont(static_cast<TTF_Font *>(it.second));
                 }
             }
@@ -177,13 +823,72 @@ namespace splashkit_lib
         }
     }
 
+    //
+    // Work out the pen position after each character of the UTF-8 text, from
+    // the glyph advances and kerning. Every byte of a character is at the
+    // same position. Returns the width of the whole text.
+    //
+    static int _sk_text_advances(TTF_Font *ttf_font, const string &text, vector<int> *positions)
+    {
+        _sk_font_metrics *metrics = _sk_get_font_metrics(ttf_font);
+        bool kerning = TTF_GetFontKerning(ttf_font) != 0;
+        int pen = 0;
+        Uint16 prev = 0;
+
+        for (size_t i = 0; i < text.length(); )
+        {
+            Uint32 cp;
+            int len = _sk_utf8_decode(text.c_str() + i, cp);
+            if (len == 0 or i + len > text.length())
+            {
+                // Treat an invalid byte as a character of its own
+                len = 1;
+                cp = static_cast<unsigned char>(text[i]);
+            }
+
+            Uint16 ch = cp > 0xffff ? 0xfffd : static_cast<Uint16>(cp);
+            if (kerning and prev) pen += TTF_GetFontKerningSizeGlyphs(ttf_font, prev, ch);
+
+            if (positions)
+                for (int b = 0; b < len; b++) (*positions)[i + b] = pen;
+
+            pen += _sk_glyph_advance(metrics, ttf_font, ch);
+            prev = ch;
+            i += len;
+        }
+
+        return pen;
+    }
+
     int sk_text_size(sk_font_data* font, int font_size, const string &text, int* w, int* h)
     {
         TTF_Font* ttf_font = _get_font(font, font_size);
 
         if (ttf_font)
         {
-            return TTF_SizeText(ttf_font, text.c_str(), w, h);
+            _sk_font_metrics *metrics = _sk_get_font_metrics(ttf_font);
+
+            auto it = metrics->sizes.find(text);
+            if (it != metrics->sizes.end())
+            {
+                *w = it->second.first;
+                *h = it->second.second;
+                return 0;
+            }
+
+            int result = TTF_SizeUTF8(ttf_font, text.c_str(), w, h);
+
+            if (result == 0)
+            {
+                // Use the same widths as sk_text_positions, so the width is
+                // where the last character ends
+                *w = _sk_text_advances(ttf_font, text, nullptr);
+
+                if (metrics->sizes.size() >= TEXT_SIZE_CACHE_LIMIT) metrics->sizes.clear();
+                metrics->sizes[text] = std::make_pair(*w, *h);
+            }
+
+            return result;
         }
         else
         {
@@ -193,6 +898,22 @@ namespace splashkit_lib
         }
     }
 
+    void sk_text_positions(sk_font_data* font, int font_size, const string &text, vector<int> &positions)
+    {
+        positions.assign(text.length() + 1, 0);
+
+        TTF_Font* ttf_font = _get_font(font, font_size);
+
+        if (!ttf_font)
+        {
+            // bitmap font is 8 pixels per character
+            for (size_t i = 0; i <= text.length(); i++) positions[i] = 8 * static_cast<int>(i);
+            return;
+        }
+
+        positions[text.length()] = _sk_text_advances(ttf_font, text, &positions);
+    }
+
     void sk_set_font_style(sk_font_data* font, int font_size, int style)
     {
         TTF_Font* ttf_font = _get_font(font, font_size);
@@ -227,6 +948,10 @@ namespace splashkit_lib
                               sk_color clr )
     {
         internal_sk_init();
+
+        // SDL_gfx's font is 8x8 pixels
+        _sk_mark_dirty(surface, x, y, 8.0 * strlen(text), 8);
+
         unsigned int count = _sk_renderer_count(surface);
 
         for (unsigned int i = 0; i < count; i++)
@@ -240,6 +965,9 @@ namespace splashkit_lib
                        static_cast<Uint8>(clr.g * 255),
                        static_cast<Uint8>(clr.b * 255),
                        static_cast<Uint8>(clr.a * 255) );
+
+            // SDL_gfx changes the renderer's draw state
+            _sk_forget_draw_state(renderer);
             _sk_complete_render(surface, i);
         }
 
@@ -271,6 +999,14 @@ namespace splashkit_lib
         sdl_color.g = static_cast<Uint8>(clr.g * 255);
         sdl_color.b = static_cast<Uint8>(clr.b * 255);
         sdl_color.a = static_cast<Uint8>(clr.a * 255);
+
+        if (_text_cache_enabled)
+        {
+            _sk_draw_cached_text(surface, ttf_font, x, y, text, sdl_color);
+            return;
+        }
+
+        if (_sk_draw_atlas_text(surface, ttf_font, font_size, x, y, text, clr)) return;
         
         text_surface = TTF_RenderUTF8_Blended(static_cast<TTF_Font *>(font->_data[font_size]), text, sdl_color);
         
@@ -280,6 +1016,8 @@ namespace splashkit_lib
         }
         else
         {
+            _sk_mark_dirty(surface, x, y, text_surface->w, text_surface->h);
+
             unsigned int count = _sk_renderer_count(surface);
             
             for (unsigned int i = 0; i < count; i++)
@@ -22,6 +22,9 @@ namespace splashkit_lib
     void sk_close_font(sk_font_data* font);
     int sk_text_line_skip(sk_font_data* font, int font_size);
     int sk_text_size(sk_font_data* font, int font_size, const string &text, int* w, int* h);
+    // positions[i] is the x offset of byte i of the text, with one extra entry
+    // for the width of the whole text
+    void sk_text_positions(sk_font_data* font, int font_size, const string &text, vector<int> &positions);
     void sk_set_font_style(sk_font_data* font, int font_size, int style);
     int sk_get_font_style(sk_font_data* font, int font_size);
     void _sk_draw_bitmap_text( sk_drawing_surface * surface,
@@ -37,5 +40,16 @@ namespace splashkit_lib
                       sk_color clr);
     
     string sk_find_system_font_path(string name);
+
+    void sk_set_text_cache(bool enabled);
+    bool sk_text_cache_enabled();
+    void sk_set_text_cache_budget(size_t bytes);
+    size_t sk_text_cache_budget();
+    void sk_clear_text_cache();
+    text_cache_statistics sk_text_cache_statistics();
+    void sk_reset_text_cache_statistics();
+
+    // Called as a window closes, to free the text textures on its renderer
+    void _sk_remove_text_textures(unsigned int window_idx);
 }
 #endif /* defined(__sgsdl2__SGSDL2Text__) */
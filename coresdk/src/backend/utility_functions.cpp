@@ -233,6 +233,22 @@ namespace splashkit_lib
         }
     }
 
+    const color *instance_colors(const vector<color> &clrs, size_t count)
+    {
+        if ( clrs.size() == count ) return clrs.data();
+
+        if ( clrs.size() != 1 )
+        {
+            LOG(WARNING) << "Drawing multiple shapes needs one color, or a color for each shape.";
+            return nullptr;
+        }
+
+        // Reused between calls, so repeated batches do not allocate
+        static vector<color> shared;
+        shared.assign(count, clrs[0]);
+        return shared.data();
+    }
+
     void xy_from_opts(const drawing_options &opts, double &x, double &y)
     {
         // check cases where drawn without camera...
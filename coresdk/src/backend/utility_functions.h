@@ -169,6 +169,10 @@ collection.erase(collection.begin());\
     sk_drawing_surface *to_surface_ptr(void *p);
     void xy_from_opts(const drawing_options &opts, double &x, double &y);
 
+    // Colors for count shapes drawn together -- clrs has one color for each
+    // shape, or one color for them all. Returns nullptr if neither is true.
+    const color *instance_colors(const vector<color> &clrs, size_t count);
+
     void process_range(string value_in, vector<int> &result);
 
     string extract_delimited(int index, string value, char delim);
@@ -26,4 +26,34 @@ namespace splashkit_lib
         //ok without SDL init... and called on load
         return SDL_GetTicks();
     }
-}
\ No newline at end of file
+
+    uint64_t sk_performance_counter()
+    {
+        return SDL_GetPerformanceCounter();
+    }
+
+    uint64_t sk_performance_frequency()
+    {
+        return SDL_GetPerformanceFrequency();
+    }
+
+    // Sleeping is only accurate to a few ms, so sleep until close to the
+    // deadline then spin on the counter for the remainder.
+    #define SK_SPIN_MS 2
+
+    void sk_wait_until(uint64_t counter)
+    {
+        uint64_t freq = SDL_GetPerformanceFrequency();
+        uint64_t now = SDL_GetPerformanceCounter();
+
+        while ( now < counter )
+        {
+            uint64_t remaining_ms = (counter - now) * 1000 / freq;
+
+            if ( remaining_ms > SK_SPIN_MS )
+                SDL_Delay(static_cast<Uint32>(remaining_ms - SK_SPIN_MS));
+
+            now = SDL_GetPerformanceCounter();
+        }
+    }
+}
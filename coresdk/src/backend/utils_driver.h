@@ -7,9 +7,16 @@
 
 #ifndef sk_Utils_h
 #define sk_Utils_h
+
+#include <cstdint>
+
 namespace splashkit_lib
 {
     void sk_delay(unsigned int ms);
     unsigned int sk_get_ticks();
+
+    uint64_t sk_performance_counter();
+    uint64_t sk_performance_frequency();
+    void sk_wait_until(uint64_t counter);
 }
 #endif /* defined(__sk__Utils__) */
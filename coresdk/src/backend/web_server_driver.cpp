@@ -10,6 +10,7 @@
 #include "concurrency_utils.h"
 #include "utility_functions.h"
 #include "core_driver.h"
+#include "object_pool.h"
 
 #include <iostream>
 #include <cstring>
@@ -20,6 +21,10 @@ namespace splashkit_lib
 {
     static map<unsigned short, sk_web_server*> servers;
 
+    // Requests are allocated on civetweb's threads and released once their
+    // response has been sent
+    static object_pool<sk_http_request> _request_pool;
+
     struct _web_server_ctx_data
     {
         unsigned short port;
@@ -44,7 +49,7 @@ namespace splashkit_lib
 
         const struct mg_request_info *request_info = mg_get_request_info(conn);
 
-        sk_http_request *r = new sk_http_request;
+        sk_http_request *r = _request_pool.allocate();
         r->id = HTTP_REQUEST_PTR;
         r->uri = request_info->request_uri ? request_info->request_uri : "" ;
         r->query_string = request_info->query_string ? request_info->query_string : "";
@@ -127,8 +132,8 @@ namespace splashkit_lib
         // Signal to the front end that the response has been sent
         r->response->response_sent.release();
 
-        // Now we can delete the request
-        delete r;
+        // Now we can release the request
+        _request_pool.release(r);
 
         // Non-zero return means civetweb has replied to client
         return 1;
@@ -229,8 +234,9 @@ namespace splashkit_lib
         // Any loaded requests
         if (server->last_request)
         {
+            // The request handler releases the request once it is flushed
             sk_flush_request(server->last_request);
-            delete server->last_request;
+            server->last_request = nullptr;
         }
 
         // Any yet to be processed requests
@@ -258,4 +264,9 @@ namespace splashkit_lib
             LOG(WARNING) << "Tried to remove from servers map a server which did not exist.";
         }
     }
+
+    pool_statistics sk_http_request_pool_statistics()
+    {
+        return _request_pool.statistics();
+    }
 }
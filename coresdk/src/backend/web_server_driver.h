@@ -23,5 +23,7 @@ namespace splashkit_lib
     sk_web_server* sk_start_web_server(unsigned short port);
 
     void sk_stop_web_server(sk_web_server *server);
+
+    pool_statistics sk_http_request_pool_statistics();
 }
 #endif /* defined(__sgsdl2__SGSDL2WebServer__) */
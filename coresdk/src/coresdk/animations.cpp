@@ -13,9 +13,11 @@
 #include "vector_2d.h"
 
 #include "utility_functions.h"
+#include "object_pool.h"
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -30,6 +32,7 @@ using std::to_string;
 namespace splashkit_lib
 {
     static map<string, animation_script> _animation_scripts;
+    static object_pool<_animation_data> _animation_pool;
 
     struct row_data
     {
@@ -46,6 +49,36 @@ namespace splashkit_lib
 
     int animation_index(animation_script temp, const string &name);
 
+    //
+    // Follow the frames from start, recording the order they are played in
+    // and when each ends. The walk stops at the end of the animation or when
+    // it returns to a frame it has already visited, which is where it loops.
+    //
+    static animation_sequence _build_animation_sequence(animation_script script, int start)
+    {
+        animation_sequence result;
+        vector<int> position(script->frames.size(), -1);
+        double time = 0;
+
+        result.loop_start = -1;
+
+        for (animation_frame *current = &script->frames[start]; current; current = current->next)
+        {
+            if ( position[current->index] >= 0 )
+            {
+                result.loop_start = position[current->index];
+                break;
+            }
+
+            position[current->index] = static_cast<int>(result.frames.size());
+            time += current->duration;
+            result.frames.push_back(current->index);
+            result.end_times.push_back(time);
+        }
+
+        return result;
+    }
+
     animation_script load_animation_script(const string &name, const string &filename)
     {
         animation_script result;
@@ -409,6 +442,7 @@ namespace splashkit_lib
                 if (sum_loop(current) == 0)
                 {
                     free_animation_script(result);
+                    result = nullptr;
                     LOG(WARNING) << "Error in animation " + filename + ". Animation contains a loop with duration 0 starting at cell " + to_string(current->index);
                     return;
                 }
@@ -462,6 +496,14 @@ namespace splashkit_lib
         build_frame_lists();
         check_animation_loops();
 
+        if (result)
+        {
+            for (int start : result->animations)
+            {
+                result->sequences.push_back(_build_animation_sequence(result, start));
+            }
+        }
+
         _animation_scripts[name] = result;
 
         return result;
@@ -546,12 +588,15 @@ namespace splashkit_lib
             notify_of_free(ani);
 
             _remove_animation(ani->script, ani);
-            ani->id = NONE_PTR;
-
-            delete(ani); //ani may have been overridden by last call...
+            _animation_pool.release(ani);
         }
     }
 
+    pool_statistics animation_pool_statistics()
+    {
+        return _animation_pool.statistics();
+    }
+
     bool has_animation_script(const string &name)
     {
         return _animation_scripts.count(name) > 0;
@@ -712,6 +757,7 @@ namespace splashkit_lib
         }
 
         anim->first_frame        = &script->frames[script->animations[idx]];
+        anim->sequence           = &script->sequences[idx];
         anim->animation_name     = animation_name(script, idx);
         restart_animation(anim, with_sound);
     }
@@ -794,12 +840,14 @@ namespace splashkit_lib
             return result;
         }
 
-        result = new(_animation_data);
+        result = _animation_pool.allocate();
 
         result->id = ANIMATION_PTR;
         result->current_frame = nullptr;
         result->last_frame = nullptr;
         result->first_frame = nullptr;
+        result->sequence = nullptr;
+        result->sequence_index = 0;
         result->entered_frame = false;
         result->animation_name = animation_name(script, idx);
         result->script = script;
@@ -852,6 +900,7 @@ namespace splashkit_lib
 
         anim->current_frame  = anim->first_frame;
         anim->last_frame     = anim->first_frame;
+        anim->sequence_index = 0;
         anim->frame_time     = 0;
         anim->entered_frame  = true;
 
@@ -869,31 +918,87 @@ namespace splashkit_lib
         update_animation(anim, pct, true);
     }
 
+    //
+    // Moves the animation on by pct, jumping straight to the frame that this
+    // much time reaches. Only the sound of the frame landed on is played.
+    //
     void update_animation(animation anim, float pct, bool with_sound)
     {
         if (animation_ended(anim)) return;
 
         anim->frame_time     = anim->frame_time + pct;
 
-        if (anim->frame_time >= anim->current_frame->duration)
+        if (anim->frame_time < anim->current_frame->duration)
         {
-            anim->frame_time = anim->frame_time - anim->current_frame->duration;    //reduce the time
-            anim->last_frame = anim->current_frame;                                 //store last frame
-            anim->current_frame = anim->current_frame->next;                        //get the next frame
+            anim->entered_frame  = false;
+            return;
+        }
+
+        const animation_sequence &seq = *anim->sequence;
+        const vector<double> &end_times = seq.end_times;
+        int idx = anim->sequence_index;
 
-            //if assigned(anim^.currentFrame) then
-            //WriteLn('Frame ', HexStr(anim^.currentFrame), ' Vector ', PointToString(anim^.currentFrame^.movement));
+        double start_time = idx > 0 ? end_times[idx - 1] : 0;
+        double elapsed = start_time + anim->frame_time;
+        double total = end_times.back();
+
+        anim->entered_frame  = true;
 
-            if (ASSIGNED(anim->current_frame) and ASSIGNED(anim->current_frame->sound) and with_sound)
+        bool wrapped = elapsed >= total;
+
+        if (wrapped)
+        {
+            if (seq.loop_start < 0)
             {
-                play_sound_effect(anim->current_frame->sound);
+                // Run off the end of the animation
+                anim->last_frame = &anim->script->frames[seq.frames.back()];
+                anim->current_frame = nullptr;
+                anim->frame_time = 0;
+                return;
             }
 
-            anim->entered_frame  = true;
+            double loop_time = seq.loop_start > 0 ? end_times[seq.loop_start - 1] : 0;
+            double loop_length = total - loop_time;
+
+            if (loop_length > 0)
+                elapsed = loop_time + fmod(elapsed - loop_time, loop_length);
+            else
+                elapsed = loop_time;
         }
-        else
+
+        // The frame being played is the first to end after the elapsed time
+        idx = static_cast<int>(upper_bound(end_times.begin(), end_times.end(), elapsed) - end_times.begin());
+        if (idx >= end_times.size()) idx = seq.loop_start >= 0 ? seq.loop_start : static_cast<int>(end_times.size()) - 1;
+
+        // Coming back round to the start of the loop follows on from the end
+        int previous = (idx == 0 or (wrapped and idx == seq.loop_start)) ? static_cast<int>(seq.frames.size()) - 1 : idx - 1;
+
+        anim->last_frame = &anim->script->frames[seq.frames[previous]];
+        anim->current_frame = &anim->script->frames[seq.frames[idx]];
+        anim->sequence_index = idx;
+        anim->frame_time = static_cast<float>(elapsed - (idx > 0 ? end_times[idx - 1] : 0));
+
+        if (ASSIGNED(anim->current_frame->sound) and with_sound)
         {
-            anim->entered_frame  = false;
+            play_sound_effect(anim->current_frame->sound);
+        }
+    }
+
+    void update_animations(const vector<animation> &anims)
+    {
+        update_animations(anims, 1.0f, true);
+    }
+
+    void update_animations(const vector<animation> &anims, float pct)
+    {
+        update_animations(anims, pct, true);
+    }
+
+    void update_animations(const vector<animation> &anims, float pct, bool with_sound)
+    {
+        for (animation anim : anims)
+        {
+            update_animation(anim, pct, with_sound);
         }
     }
 }
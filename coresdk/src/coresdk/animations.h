@@ -16,7 +16,9 @@
 #include "drawing_options.h"
 
 #include <string>
+#include <vector>
 using std::string;
+using std::vector;
 
 namespace splashkit_lib
 {
@@ -218,6 +220,15 @@ namespace splashkit_lib
      */
     void free_animation(animation ani);
 
+    /**
+     * Returns statistics on the pooled storage used for animations. Freed
+     * animations return their storage to the pool, where it is reused by the
+     * next animation created.
+     *
+     * @returns The current animation pool statistics.
+     */
+    pool_statistics animation_pool_statistics();
+
     /**
      * Setup an `animation` to follow the script from an indicated index.
      * This uses the index from the current animation script and
@@ -529,8 +540,9 @@ namespace splashkit_lib
 
     /**
      * Updates the animation, updating the time spent and possibly moving to
-     * a new frame in the animation. This may play a sound effect if the new
-     * frame triggers a sound.
+     * a new frame in the animation. When `pct` covers several frames the
+     * animation moves straight to the frame this time reaches, and only that
+     * frame's sound effect is played.
      *
      * @param anim          The `animation` to update.
      * @param pct           The amount that the frame time will be incremented
@@ -539,6 +551,42 @@ namespace splashkit_lib
      * @attribute suffix    percent_with_sound
      */
     void update_animation(animation anim, float pct, bool with_sound);
+
+    /**
+     * Updates each of the animations, as if `update_animation` was called on
+     * each in turn. An update that covers several frames moves straight to
+     * the frame that the elapsed time reaches.
+     *
+     * @param anims         The animations to update.
+     *
+     * @attribute suffix    all
+     */
+    void update_animations(const vector<animation> &anims);
+
+    /**
+     * Updates each of the animations, as if `update_animation` was called on
+     * each in turn. An update that covers several frames moves straight to
+     * the frame that the elapsed time reaches.
+     *
+     * @param anims         The animations to update.
+     * @param pct           The amount that the frame time will be incremented
+     *
+     * @attribute suffix    all_percent
+     */
+    void update_animations(const vector<animation> &anims, float pct);
+
+    /**
+     * Updates each of the animations, as if `update_animation` was called on
+     * each in turn. An update that covers several frames moves straight to
+     * the frame that the elapsed time reaches.
+     *
+     * @param anims         The animations to update.
+     * @param pct           The amount that the frame time will be incremented
+     * @param with_sound    Denotes whether the animations should play audio.
+     *
+     * @attribute suffix    all_percent_with_sound
+     */
+    void update_animations(const vector<animation> &anims, float pct, bool with_sound);
 }
 
 #endif /* animations_h */
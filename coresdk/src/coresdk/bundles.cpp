@@ -16,6 +16,11 @@
 #include "text.h"
 #include "audio.h"
 
+#include "graphics_driver.h"
+#include "collision_mask.h"
+#include "concurrency_utils.h"
+#include "utils_driver.h"
+
 #include <map>
 #include <vector>
 #include <iostream>
@@ -26,6 +31,11 @@ using std::to_string;
 
 namespace splashkit_lib
 {
+    // From images.cpp
+    bool _locate_bitmap_file(const string &name, const string &filename, string &file_path);
+    _collision_mask *_decode_bitmap_file(const string &file_path, sk_decoded_bitmap *image);
+    bitmap _add_decoded_bitmap(const string &name, const string &file_path, sk_decoded_bitmap *image, _collision_mask *mask);
+
     struct bundled_resource
     {
         resource_kind kind;
@@ -37,10 +47,44 @@ namespace splashkit_lib
         string                      name;
         string                      filename;
         vector<bundled_resource>    resources;
+        resource_bundle_progress    progress;
     };
 
     static map<string, resource_bundle> _resource_bundles;
 
+    // A resource from a bundle file that is waiting to be loaded
+    struct _bundle_load_job
+    {
+        resource_kind       kind;
+        string              name;
+        string              path;
+        string              line;
+        int                 line_no;
+        int                 bytes;
+
+        // Bitmaps are decoded on the workers, along with their mask
+        string              file_path;
+        sk_decoded_bitmap   image;
+        _collision_mask     *mask;
+    };
+
+    // A bundle that is part way through loading. Workers only touch their
+    // own job, and the jobs are not changed once the workers have started.
+    struct _bundle_load
+    {
+        resource_bundle             result;
+        vector<_bundle_load_job>    jobs;
+        vector<size_t>              main_jobs;      // loaded on the main thread, in bundle order
+        size_t                      next_main_job;
+        size_t                      decoding;       // jobs still with the workers
+        channel<size_t>             decoded;        // jobs the workers have finished
+        resource_bundle_progress    progress;
+    };
+
+    static map<string, _bundle_load *> _loading_bundles;
+
+    // Time spent loading resources each time a loading bundle is checked
+    #define BUNDLE_LOAD_STEP_MS 8
 
     bool has_resource_bundle(const string &name)
     {
@@ -62,114 +106,208 @@ namespace splashkit_lib
         else return OTHER_RESOURCE;
     }
 
-    void load_resource_bundle(const string &name, const string &filename)
+    // The size of a resource's file, used to report progress in bytes
+    static int _bundle_file_size(const string &path, resource_kind kind)
     {
-        if ( has_resource_bundle(name) )
+        string file_path = path;
+        if ( ! file_exists(file_path) ) file_path = path_to_resource(path, kind);
+
+        ifstream input(file_path, std::ios::binary | std::ios::ate);
+        if ( ! input ) return 0;
+
+        return static_cast<int>(input.tellg());
+    }
+
+    // Apply the cell details from the bundle line to a loaded bitmap
+    static void _setup_bundle_bitmap(const string &bundle_name, const _bundle_load_job &job)
+    {
+        bitmap bmp = bitmap_named(job.name);
+        int num_delim = count_delimiter(job.line, ',');
+        if ( num_delim > 2 and num_delim != 7 )
         {
-            LOG(WARNING) << "Attempting to load resource bundle twice.";
+            LOG(WARNING) << "Incorrect cell options for bitmap " + job.name + " at " + to_string(job.line_no) + " of bundle " + bundle_name;
             return;
         }
+        else if ( num_delim == 2 ) return;
+
+        bitmap_set_cell_details(bmp,
+                                str_to_int(extract_delimited(4, job.line, ',')),
+                                str_to_int(extract_delimited(5, job.line, ',')),
+                                str_to_int(extract_delimited(6, job.line, ',')),
+                                str_to_int(extract_delimited(7, job.line, ',')),
+                                str_to_int(extract_delimited(8, job.line, ',')));
+    }
+
+    static void _complete_bundle_job(_bundle_load *load, const _bundle_load_job &job, bool loaded)
+    {
+        load->progress.completed++;
+        load->progress.bytes_loaded += job.bytes;
+
+        if ( ! loaded ) return;
+
+        if ( job.kind == IMAGE_RESOURCE ) _setup_bundle_bitmap(load->result.name, job);
+
+        bundled_resource br;
+        br.name = job.name;
+        br.kind = job.kind;
+
+        load->result.resources.push_back(br);
+    }
+
+    // Load a resource that must be created on the main thread
+    static void _load_main_bundle_job(_bundle_load *load, const _bundle_load_job &job)
+    {
+        bool loaded;
+
+        switch ( job.kind )
+        {
+            case BUNDLE_RESOURCE:
+                load_resource_bundle(job.name, job.path);
+                loaded = has_resource_bundle(job.name);
+                break;
+            case TIMER_RESOURCE:
+                create_timer(job.name);
+                loaded = true;
+                break;
+            case IMAGE_RESOURCE:
+                load_bitmap(job.name, job.path);
+                loaded = has_bitmap(job.name);
+                break;
+            case FONT_RESOURCE:
+                load_font(job.name, job.path);
+                loaded = has_font(job.name);
+                break;
+            case SOUND_RESOURCE:
+                load_sound_effect(job.name, job.path);
+                loaded = has_sound_effect(job.name);
+                break;
+            case MUSIC_RESOURCE:
+                load_music(job.name, job.path);
+                loaded = has_music(job.name);
+                break;
+            case ANIMATION_RESOURCE:
+                load_animation_script(job.name, job.path);
+                loaded = has_animation_script(job.name);
+                break;
+            default:
+                loaded = false;
+        }
+
+        _complete_bundle_job(load, job, loaded);
+    }
+
+    // Upload a bitmap the workers have decoded
+    static void _finish_decoded_bundle_job(_bundle_load *load, size_t idx)
+    {
+        _bundle_load_job &job = load->jobs[idx];
+        load->decoding--;
+
+        if ( has_bitmap(job.name) )
+        {
+            // loaded by something else while it was being decoded
+            sk_free_decoded_bitmap(&job.image);
+            free_collision_mask(job.mask);
+        }
+        else
+        {
+            _add_decoded_bitmap(job.name, job.file_path, &job.image, job.mask);
+        }
+
+        _complete_bundle_job(load, job, has_bitmap(job.name));
+    }
+
+    // Read the bundle file and start decoding its bitmaps on the workers.
+    // Everything else is left to load on the main thread.
+    static _bundle_load *_start_bundle_load(const string &name, const string &filename)
+    {
+        if ( has_resource_bundle(name) or _loading_bundles.count(name) > 0 )
+        {
+            LOG(WARNING) << "Attempting to load resource bundle twice.";
+            return nullptr;
+        }
 
         string path = path_to_resource(filename, BUNDLE_RESOURCE);
 
         if ( ! file_exists(path) )
         {
             LOG(WARNING) << cat({ "Unable to locate bundle file for ", name, " (", path, ")"});
-            return;
+            return nullptr;
         }
 
         int line_no = 0;
         string line;
         ifstream input(path);
 
-        resource_bundle result;
+        _bundle_load *load = new _bundle_load;
+        load->result.name = name;
+        load->result.filename = filename;
+        load->next_main_job = 0;
+        load->decoding = 0;
+        load->progress = { 0, 0, 0, 0, false, false };
 
-        // Called on load of each bitmap
-        auto rb_load_bitmap = [&](string line_name, string line_path)
-        {
-            bitmap bmp = load_bitmap(line_name, line_path);
-            int num_delim = count_delimiter(line, ',');
-            if ( num_delim > 2 and num_delim != 7 )
-            {
-                LOG(WARNING) << "Incorrect cell options for bitmap " + line_name + " at " + to_string(line_no) + " of bundle " + name;
-                return;
-            }
-            else if ( num_delim == 2 ) return;
-
-            bitmap_set_cell_details(bmp,
-                                    str_to_int(extract_delimited(4, line, ',')),
-                                    str_to_int(extract_delimited(5, line, ',')),
-                                    str_to_int(extract_delimited(6, line, ',')),
-                                    str_to_int(extract_delimited(7, line, ',')),
-                                    str_to_int(extract_delimited(8, line, ',')));
-        };
+        vector<size_t> worker_jobs;
 
         // Called for each line in the bundle text file
         auto process_line = [&]()
         {
-            resource_kind kind = string_to_resource_kind(extract_delimited(1, line, ','));
-            string line_name = trim(extract_delimited(2, line, ','));
-            string line_path = trim(extract_delimited(3, line, ','));
-
-
-            if ( kind == OTHER_RESOURCE )
+            _bundle_load_job job;
+            job.kind = string_to_resource_kind(extract_delimited(1, line, ','));
+            job.name = trim(extract_delimited(2, line, ','));
+            job.path = trim(extract_delimited(3, line, ','));
+            job.line = line;
+            job.line_no = line_no;
+            job.bytes = 0;
+            job.image = { 0, 0, nullptr };
+            job.mask = nullptr;
+
+            if ( job.kind == OTHER_RESOURCE )
             {
                 LOG(WARNING) << "Unknown resource type at line " + to_string(line_no) + " of bundle " + name;
                 return;
             }
 
-            if ( line_name.length() == 0 )
+            if ( job.name.length() == 0 )
             {
                 LOG(WARNING) << "Name missing for resource at line " + to_string(line_no) + " of bundle " + name;
                 return;
             }
 
-            if ( line_path.length() == 0 && kind != TIMER_RESOURCE )
+            if ( job.path.length() == 0 && job.kind != TIMER_RESOURCE )
             {
                 LOG(WARNING) << "Name missing for resource at line " + to_string(line_no) + " of bundle " + name;
                 return;
             }
 
-            switch ( kind )
+            bool decode = false;
+
+            if ( job.kind == IMAGE_RESOURCE and ! has_bitmap(job.name) )
             {
-                case BUNDLE_RESOURCE:
-                    load_resource_bundle(line_name, line_path);
-                    if ( ! has_resource_bundle(line_name) ) return;
-                    break;
-                case TIMER_RESOURCE:
-                    create_timer(line_name);
-                    break;
-                case IMAGE_RESOURCE:
-                    rb_load_bitmap(line_name, line_path);
-                    if ( ! has_resource_bundle(line_name) ) return;
-                    break;
-                case FONT_RESOURCE:
-                    load_font(line_name, line_path);
-                    if ( ! has_font(line_name) ) return;
-                    break;
-                case SOUND_RESOURCE:
-                    load_sound_effect(line_name, line_path);
-                    if ( ! has_sound_effect(line_name) ) return;
-                    break;
-                case MUSIC_RESOURCE:
-                    load_music(line_name, line_path);
-                    if ( ! has_music(line_name) ) return;
-                    break;
-                case ANIMATION_RESOURCE:
-                    load_animation_script(line_name, line_path);
-                    if ( ! has_animation_script(line_name) ) return;
-                    break;
-                default:
-                    return;
+                for (size_t i : worker_jobs)
+                {
+                    if ( load->jobs[i].name == job.name )
+                    {
+                        LOG(WARNING) << "Duplicate bitmap " + job.name + " at line " + to_string(line_no) + " of bundle " + name;
+                        return;
+                    }
+                }
+
+                if ( ! _locate_bitmap_file(job.name, job.path, job.file_path) ) return;
+                job.bytes = _bundle_file_size(job.file_path, IMAGE_RESOURCE);
+                decode = true;
+            }
+            else if ( job.kind != TIMER_RESOURCE )
+            {
+                job.bytes = _bundle_file_size(job.path, job.kind);
             }
 
-            bundled_resource br;
-            br.name = line_name;
-            br.kind = kind;
-
-            result.resources.push_back(br);
+            if ( decode )
+                worker_jobs.push_back(load->jobs.size());
+            else
+                load->main_jobs.push_back(load->jobs.size());
 
-            return;
+            load->progress.total++;
+            load->progress.bytes_total += job.bytes;
+            load->jobs.push_back(job);
         };
 
         while (getline(input, line))
@@ -183,11 +321,98 @@ namespace splashkit_lib
             process_line();
         }
 
-        _resource_bundles[name] = result;
+        _loading_bundles[name] = load;
+
+        if ( worker_jobs.size() == 0 ) return load;
+
+        sk_init_image_decoding();
+
+        load->decoding = worker_jobs.size();
+
+        for (size_t idx : worker_jobs)
+        {
+            shared_worker_pool().run([load, idx]()
+            {
+                _bundle_load_job &job = load->jobs[idx];
+                job.mask = _decode_bitmap_file(job.file_path, &job.image);
+                load->decoded.put(idx);
+            });
+        }
+
+        return load;
+    }
+
+    // Load the resources that are ready. Unless waiting for the whole
+    // bundle, return once the time for this step is used up.
+    static void _continue_bundle_load(const string &name, bool wait)
+    {
+        if ( _loading_bundles.count(name) == 0 ) return;
+
+        _bundle_load *load = _loading_bundles[name];
+        unsigned int start = sk_get_ticks();
+
+        while ( true )
+        {
+            size_t idx;
+
+            if ( load->decoding > 0 and load->decoded.try_take(idx) )
+                _finish_decoded_bundle_job(load, idx);
+            else if ( load->next_main_job < load->main_jobs.size() )
+                _load_main_bundle_job(load, load->jobs[load->main_jobs[load->next_main_job++]]);
+            else if ( load->decoding > 0 and wait )
+                _finish_decoded_bundle_job(load, load->decoded.take());
+            else
+                break;
+
+            if ( not wait and sk_get_ticks() - start >= BUNDLE_LOAD_STEP_MS ) break;
+        }
+
+        if ( load->decoding > 0 or load->next_main_job < load->main_jobs.size() ) return;
+
+        load->progress.done = true;
+        load->result.progress = load->progress;
+
+        _loading_bundles.erase(name);
+        _resource_bundles[name] = load->result;
+        delete load;
+    }
+
+    void load_resource_bundle(const string &name, const string &filename)
+    {
+        if ( _start_bundle_load(name, filename) )
+            _continue_bundle_load(name, true);
+    }
+
+    void load_resource_bundle_async(const string &name, const string &filename)
+    {
+        _start_bundle_load(name, filename);
+    }
+
+    resource_bundle_progress resource_bundle_load_progress(const string &name)
+    {
+        _continue_bundle_load(name, false);
+
+        if ( _loading_bundles.count(name) > 0 )
+            return _loading_bundles[name]->progress;
+
+        if ( has_resource_bundle(name) )
+            return _resource_bundles[name].progress;
+
+        // Never started, or failed to start, so there is nothing to wait for
+        LOG(WARNING) << "Attempting to get progress of unknown resource bundle named " + name;
+        return { 0, 0, 0, 0, true, true };
+    }
+
+    void wait_for_resource_bundle(const string &name)
+    {
+        _continue_bundle_load(name, true);
     }
 
     void free_resource_bundle(const string name)
     {
+        // finish loading first, so the workers are done with the bundle
+        wait_for_resource_bundle(name);
+
         if ( ! has_resource_bundle(name) )
         {
             LOG(WARNING) << "Attempting to free unloaded resource bundle named " + name;
@@ -232,6 +457,11 @@ namespace splashkit_lib
 
     void free_all_resource_bundles()
     {
+        while ( _loading_bundles.size() > 0 )
+        {
+            wait_for_resource_bundle(_loading_bundles.begin()->first);
+        }
+
         for (unsigned long i = _resource_bundles.size(); i > 0 ; i--)
         {
             free_resource_bundle(_resource_bundles.begin()->first);
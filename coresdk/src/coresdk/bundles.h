@@ -16,6 +16,8 @@
 #ifndef bundles_h
 #define bundles_h
 
+#include "types.h"
+
 #include <string>
 using std::string;
 
@@ -111,13 +113,51 @@ namespace splashkit_lib
      *    BUNDLE,another bundle,another.txt
      *    ```
      *
+     * Bitmaps in the bundle are read and decoded on background threads while
+     * the other resources load, so a large bundle loads faster than loading
+     * each resource in turn.
+     *
      * @param name      The name of the bundle when it is loaded.
      * @param filename  The filename to load.
      */
     void load_resource_bundle(const string &name, const string &filename);
 
+    /**
+     * Starts loading the resources in the resource bundle, returning before
+     * they have loaded. The bundle file uses the same format as
+     * `load_resource_bundle`. Bitmaps are read and decoded on background
+     * threads. The rest of the loading happens a little at a time each time
+     * you call `resource_bundle_load_progress`, so call it each frame to
+     * keep your loading screen drawing while the bundle loads.
+     *
+     * @param name      The name of the bundle when it is loaded.
+     * @param filename  The filename to load.
+     */
+    void load_resource_bundle_async(const string &name, const string &filename);
+
+    /**
+     * Continues loading a bundle started with `load_resource_bundle_async`,
+     * and returns how far it has got. The bundle has loaded when the
+     * progress is done, at which point `has_resource_bundle` returns true.
+     * If the bundle could not be loaded the progress is both done and
+     * failed.
+     *
+     * @param name  The name of the resource bundle.
+     * @returns     The number of resources, and bytes, loaded so far.
+     */
+    resource_bundle_progress resource_bundle_load_progress(const string &name);
+
+    /**
+     * Waits for a bundle started with `load_resource_bundle_async` to finish
+     * loading.
+     *
+     * @param name  The name of the resource bundle.
+     */
+    void wait_for_resource_bundle(const string &name);
+
     /**
      * Returns true when the named resource bundle has already been loaded.
+     * Bundles that are still loading are not included.
      *
      * @param name  The name of the resource bundle.
      * @returns     True when the bundle is already loaded.
@@ -80,6 +80,37 @@ namespace splashkit_lib
     {
         fill_circle(clr, c.center.x, c.center.y, c.radius, option_defaults());
     }
+
+    void fill_circles(const vector<color> &clrs, const vector<circle> &circles, drawing_options opts)
+    {
+        if ( circles.empty() ) return;
+
+        sk_drawing_surface *surface = to_surface_ptr(opts.dest);
+        const color *instance_clrs = instance_colors(clrs, circles.size());
+
+        if ( not surface or not instance_clrs ) return;
+
+        // 3 values per circle, reused between calls
+        static vector<double> data;
+        data.resize(circles.size() * 3);
+
+        for (size_t i = 0; i < circles.size(); i++)
+        {
+            double x = circles[i].center.x, y = circles[i].center.y;
+            xy_from_opts(opts, x, y);
+
+            data[i * 3] = x;
+            data[i * 3 + 1] = y;
+            data[i * 3 + 2] = abs(circles[i].radius);
+        }
+
+        sk_fill_circles(surface, instance_clrs, data.data(), static_cast<int>(circles.size()));
+    }
+
+    void fill_circles(const vector<color> &clrs, const vector<circle> &circles)
+    {
+        fill_circles(clrs, circles, option_defaults());
+    }
     
     void draw_circle_on_window(window destination, color clr, double x, double y, double radius, drawing_options opts)
     {
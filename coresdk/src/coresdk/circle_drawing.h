@@ -121,6 +121,28 @@ namespace splashkit_lib
      * @attribute self      c
      */
     void fill_circle(color clr, const circle &c);
+
+    /**
+     * Fill a number of circles in one go. This is much faster than calling
+     * `fill_circle` for each circle, so use this when drawing lots of
+     * particles or other small shapes.
+     *
+     * @param clrs      The color of each circle, or a single color for them all
+     * @param circles   The circles to fill
+     * @param opts      The drawing options
+     *
+     * @attribute suffix    with_options
+     */
+    void fill_circles(const vector<color> &clrs, const vector<circle> &circles, drawing_options opts);
+
+    /**
+     * Fill a number of circles on the current window in one go. This is much
+     * faster than calling `fill_circle` for each circle.
+     *
+     * @param clrs      The color of each circle, or a single color for them all
+     * @param circles   The circles to fill
+     */
+    void fill_circles(const vector<color> &clrs, const vector<circle> &circles);
     
     /**
      *  Draw a circle to the window using the supplied drawing options. The circle is centred on its x, y
@@ -10,9 +10,11 @@
 #include "physics.h"
 #include "sprites.h"
 #include "utility_functions.h"
+#include "collision_mask.h"
 
 #include <cmath>
 #include <functional>
+#include <algorithm>
 
 #include "graphics.h"
 #include "utils.h"
@@ -23,6 +25,45 @@ namespace splashkit_lib
 {
     //#define DEBUG_STEP
 
+    // A bitmap cell's part of the collision mask, so pixels can be tested
+    // without the checks in pixel_drawn_at_point
+    struct _cell_mask
+    {
+        const _collision_mask *mask;
+        int x, y;               // Position of the cell in the bitmap
+        _mask_bounds bounds;    // Opaque area within the cell
+        const unsigned char *blocks;    // Block states, or nullptr
+        int w, h;               // Size of the cell
+    };
+
+    // Returns false when the cell has nothing that can collide
+    static bool _get_cell_mask(bitmap bmp, int cell, _cell_mask &result)
+    {
+        if ( INVALID_PTR(bmp, BITMAP_PTR) or bmp->pixel_mask == nullptr ) return false;
+
+        vector_2d offset = bitmap_cell_offset(bmp, cell);
+
+        result.mask = bmp->pixel_mask;
+        result.x = static_cast<int>(offset.x);
+        result.y = static_cast<int>(offset.y);
+
+        result.w = bmp->cell_w;
+        result.h = bmp->cell_h;
+        result.blocks = collision_mask_cell_blocks(bmp->pixel_mask, cell);
+
+        if ( cell >= 0 and cell < bmp->pixel_mask->cell_count )
+            result.bounds = bmp->pixel_mask->cell_bounds[cell];
+        else
+            result.bounds = { 0, 0, bmp->cell_w - 1, bmp->cell_h - 1 };
+
+        return result.bounds.right >= result.bounds.left;
+    }
+
+    static inline bool _cell_pixel(const _cell_mask &m, int x, int y)
+    {
+        return collision_mask_pixel(m.mask, m.x + x, m.y + y);
+    }
+
     // Step over pixels in the two areas based on the supplied matrix
     //
     // See http://www.austincc.edu/cchrist1/GAME1343/TransformedCollision/TransformedCollision.htm
@@ -118,8 +159,219 @@ namespace splashkit_lib
         return false;
     }
 
+    // Is the matrix only a move, with no rotation or scaling?
+    static bool _is_translation(const matrix_2d &m)
+    {
+        return m.elements[0][0] == 1 and m.elements[0][1] == 0 and m.elements[1][0] == 0 and m.elements[1][1] == 1;
+    }
+
+    // Compare the pixels of a between x0..x1 and y0..y1 with b, where pixel
+    // (x, y) of a is over pixel (x + ox, y + oy) of b
+    static bool _offset_masks_overlap(const _cell_mask &a, const _cell_mask &b, int ox, int oy, int x0, int x1, int y0, int y1)
+    {
+        // overlap of the opaque areas, in a's coordinates
+        int left = std::max(std::max(x0, a.bounds.left), b.bounds.left - ox);
+        int right = std::min(std::min(x1, a.bounds.right), b.bounds.right - ox);
+        int top = std::max(std::max(y0, a.bounds.top), b.bounds.top - oy);
+        int bottom = std::min(std::min(y1, a.bounds.bottom), b.bounds.bottom - oy);
+
+        // keep within both masks
+        left = std::max(left, std::max(-a.x, -b.x - ox));
+        top = std::max(top, std::max(-a.y, -b.y - oy));
+        right = std::min(right, std::min(a.mask->width - 1 - a.x, b.mask->width - 1 - b.x - ox));
+        bottom = std::min(bottom, std::min(a.mask->height - 1 - a.y, b.mask->height - 1 - b.y - oy));
+
+        if ( right < left or bottom < top ) return false;
+
+        return collision_masks_overlap(a.mask, a.x + left, a.y + top,
+                                       b.mask, b.x + left + ox, b.y + top + oy,
+                                       right - left + 1, bottom - top + 1);
+    }
+
+    // Both cells are only moved, so line up their masks and compare whole
+    // words. Pixels map as they do in _step_through_pixels: from the smaller
+    // cell, truncating, so a pixel landing in (-1, 0) is over pixel 0.
+    static bool _translated_masks_collide(const _cell_mask &m1, const matrix_2d &matrix1, const _cell_mask &m2, const matrix_2d &matrix2)
+    {
+        bool a_is_1 = m1.w * m1.h <= m2.w * m2.h;
+        const _cell_mask &a = a_is_1 ? m1 : m2;
+        const _cell_mask &b = a_is_1 ? m2 : m1;
+        const matrix_2d &matrix_a = a_is_1 ? matrix1 : matrix2;
+        const matrix_2d &matrix_b = a_is_1 ? matrix2 : matrix1;
+
+        // pixel x of a lands at x + dx in b
+        double dx = matrix_a.elements[0][2] - matrix_b.elements[0][2];
+        double dy = matrix_a.elements[1][2] - matrix_b.elements[1][2];
+
+        // Most of a is over b offset by floor(d). With a fractional offset,
+        // the one column (or row) of a that lands in (-1, 0) truncates onto
+        // b's first column (or row) instead.
+        int ox = static_cast<int>(floor(dx)), oy = static_cast<int>(floor(dy));
+        int edge_x = -ox - 1, edge_y = -oy - 1;
+
+        struct span { int offset, from, to; };
+        span xs[2] = { { ox, 0, a.w - 1 }, { ox + 1, edge_x, edge_x } };
+        span ys[2] = { { oy, 0, a.h - 1 }, { oy + 1, edge_y, edge_y } };
+        int x_spans = dx != ox ? 2 : 1;
+        int y_spans = dy != oy ? 2 : 1;
+
+        for (int i = 0; i < x_spans; i++)
+        {
+            for (int j = 0; j < y_spans; j++)
+            {
+                if ( _offset_masks_overlap(a, b, xs[i].offset, ys[j].offset, xs[i].from, xs[i].to, ys[j].from, ys[j].to) )
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Project the 4 points onto an axis, returning the range covered
+    static void _project(const vector_2d pts[4], const vector_2d &axis, double &lo, double &hi)
+    {
+        lo = hi = dot_product(pts[0], axis);
+        for (int i = 1; i < 4; i++)
+        {
+            double d = dot_product(pts[i], axis);
+            if ( d < lo ) lo = d;
+            if ( d > hi ) hi = d;
+        }
+    }
+
+    // Rotated or scaled cells are compared block by block first. Blocks of
+    // a that land on no opaque block of b are skipped, full blocks landing
+    // on full blocks are a hit, and only the rest are stepped through pixel
+    // by pixel -- using the same mapping as _step_through_pixels.
+    static bool _transformed_blocks_collide(const _cell_mask &a, const matrix_2d &matrix_a, const _cell_mask &b, const matrix_2d &matrix_b)
+    {
+        matrix_2d transform_a_to_b = matrix_multiply(matrix_a, matrix_inverse(matrix_b));
+
+        vector_2d origin = matrix_multiply(transform_a_to_b, vector_to(0, 0));
+        vector_2d step_x = vector_subtract(matrix_multiply(transform_a_to_b, vector_to(1, 0)), origin);
+        vector_2d step_y = vector_subtract(matrix_multiply(transform_a_to_b, vector_to(0, 1)), origin);
+
+        // Where pixel (x, y) of a lands in b
+        auto position_in_b = [&](int x, int y)
+        {
+            return vector_add(origin, vector_add(vector_multiply(step_x, x), vector_multiply(step_y, y)));
+        };
+
+        auto pixel_hit = [&](int ax, int ay)
+        {
+            vector_2d pos = position_in_b(ax, ay);
+            int bx = trunc(pos.x), by = trunc(pos.y);
+
+            return 0 <= bx and bx < b.w and 0 <= by and by < b.h and _cell_pixel(b, bx, by);
+        };
+
+        // Edge normals of a block once it is in b's space
+        vector_2d axes[2] = { vector_to(-step_x.y, step_x.x), vector_to(-step_y.y, step_y.x) };
+
+        int cols_a = (a.w + MASK_BLOCK_SIZE - 1) / MASK_BLOCK_SIZE, rows_a = (a.h + MASK_BLOCK_SIZE - 1) / MASK_BLOCK_SIZE;
+        int cols_b = (b.w + MASK_BLOCK_SIZE - 1) / MASK_BLOCK_SIZE, rows_b = (b.h + MASK_BLOCK_SIZE - 1) / MASK_BLOCK_SIZE;
+
+        for (int ay_blk = 0; ay_blk < rows_a; ay_blk++)
+        {
+            for (int ax_blk = 0; ax_blk < cols_a; ax_blk++)
+            {
+                unsigned char state_a = a.blocks[ay_blk * cols_a + ax_blk];
+                if ( state_a == MASK_BLOCK_EMPTY ) continue;
+
+                // The pixels in this block of a
+                int x0 = ax_blk * MASK_BLOCK_SIZE, x1 = std::min(x0 + MASK_BLOCK_SIZE, a.w) - 1;
+                int y0 = ay_blk * MASK_BLOCK_SIZE, y1 = std::min(y0 + MASK_BLOCK_SIZE, a.h) - 1;
+
+                vector_2d corners[4] = { position_in_b(x0, y0), position_in_b(x1, y0), position_in_b(x0, y1), position_in_b(x1, y1) };
+
+                // The blocks of b under this block's bounding box, allowing
+                // for positions in (-1, 0) truncating to pixel 0
+                double min_x = corners[0].x, max_x = min_x, min_y = corners[0].y, max_y = min_y;
+                for (int i = 1; i < 4; i++)
+                {
+                    min_x = std::min(min_x, corners[i].x); max_x = std::max(max_x, corners[i].x);
+                    min_y = std::min(min_y, corners[i].y); max_y = std::max(max_y, corners[i].y);
+                }
+
+                int bx_lo = std::max(0, static_cast<int>(floor(min_x / MASK_BLOCK_SIZE)));
+                int bx_hi = std::min(cols_b - 1, static_cast<int>(floor((max_x + 1) / MASK_BLOCK_SIZE)));
+                int by_lo = std::max(0, static_cast<int>(floor(min_y / MASK_BLOCK_SIZE)));
+                int by_hi = std::min(rows_b - 1, static_cast<int>(floor((max_y + 1) / MASK_BLOCK_SIZE)));
+
+                bool overlaps = false;
+
+                for (int by_blk = by_lo; by_blk <= by_hi and not overlaps; by_blk++)
+                {
+                    for (int bx_blk = bx_lo; bx_blk <= bx_hi and not overlaps; bx_blk++)
+                    {
+                        if ( b.blocks[by_blk * cols_b + bx_blk] == MASK_BLOCK_EMPTY ) continue;
+
+                        // Check the block's edges for a separating axis. The
+                        // box is widened by a pixel as positions in (-1, 0)
+                        // truncate to pixel 0.
+                        double left = bx_blk * MASK_BLOCK_SIZE - 1, right = (bx_blk + 1) * MASK_BLOCK_SIZE;
+                        double top = by_blk * MASK_BLOCK_SIZE - 1, bottom = (by_blk + 1) * MASK_BLOCK_SIZE;
+                        vector_2d box[4] = { vector_to(left, top), vector_to(right, top), vector_to(left, bottom), vector_to(right, bottom) };
+
+                        bool separated = false;
+                        for (int i = 0; i < 2 and not separated; i++)
+                        {
+                            double lo_a, hi_a, lo_b, hi_b;
+                            _project(corners, axes[i], lo_a, hi_a);
+                            _project(box, axes[i], lo_b, hi_b);
+                            separated = hi_a < lo_b or hi_b < lo_a;
+                        }
+
+                        overlaps = not separated;
+                    }
+                }
+
+                if ( not overlaps ) continue;
+
+                // Full block on a full block... check the middle of a's block lands on it
+                if ( state_a == MASK_BLOCK_FULL )
+                {
+                    vector_2d mid = position_in_b((x0 + x1) / 2, (y0 + y1) / 2);
+                    int bx = trunc(mid.x), by = trunc(mid.y);
+
+                    if ( 0 <= bx and bx < b.w and 0 <= by and by < b.h and
+                         b.blocks[(by / MASK_BLOCK_SIZE) * cols_b + bx / MASK_BLOCK_SIZE] == MASK_BLOCK_FULL )
+                        return true;
+                }
+
+                for (int y = y0; y <= y1; y++)
+                {
+                    for (int x = x0; x <= x1; x++)
+                    {
+                        if ( _cell_pixel(a, x, y) and pixel_hit(x, y) ) return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
     bool _collision_within_bitmap_images_with_translation(bitmap bmp1, int c1, const matrix_2d &matrix1, bitmap bmp2, int c2, const matrix_2d &matrix2)
     {
+        _cell_mask m1, m2;
+
+        if ( not _get_cell_mask(bmp1, c1, m1) or not _get_cell_mask(bmp2, c2, m2) ) return false;
+
+#if !DEBUG_STEP
+        if ( _is_translation(matrix1) and _is_translation(matrix2) )
+            return _translated_masks_collide(m1, matrix1, m2, matrix2);
+
+        if ( m1.blocks and m2.blocks )
+        {
+            // Step through the smaller cell, as _step_through_pixels does
+            if ( m1.w * m1.h <= m2.w * m2.h )
+                return _transformed_blocks_collide(m1, matrix1, m2, matrix2);
+            else
+                return _transformed_blocks_collide(m2, matrix2, m1, matrix1);
+        }
+#endif
+
         return _step_through_pixels(bitmap_cell_width(bmp1), bitmap_cell_height(bmp1), matrix1,
                                     bitmap_cell_width(bmp2), bitmap_cell_height(bmp2), matrix2,
                                     [&](int ax, int ay, int bx, int by)
@@ -139,7 +391,7 @@ namespace splashkit_lib
                                             fill_circle(COLOR_YELLOW, bpt.x, bpt.y, 3);
                                         }
 #endif
-                                        return pixel_drawn_at_point(bmp1, c1, ax, ay) and pixel_drawn_at_point(bmp2, c2, bx, by);
+                                        return _cell_pixel(m1, ax, ay) and _cell_pixel(m2, bx, by);
                                     });
     }
 
@@ -155,6 +407,9 @@ namespace splashkit_lib
             return false;
         }
 
+        _cell_mask m;
+        if ( not _get_cell_mask(bmp, cell, m) ) return false;
+
         return _step_through_pixels(1, 1, translation_matrix(pt.x, pt.y), bmp->cell_w, bmp->cell_h, translation, [&](int ax, int ay, int bx, int by)
                                     {
 #if DEBUG_STEP
@@ -163,7 +418,7 @@ namespace splashkit_lib
                                         if (pixel_drawn_at_point(bmp, cell, bx, by))
                                             fill_rectangle(COLOR_PINK, bpt.x, bpt.y, translation.elements[0][0], translation.elements[1][1]);
 #endif
-                                        return pixel_drawn_at_point(bmp, cell, bx, by);
+                                        return _cell_pixel(m, bx, by);
                                     });
     }
 
@@ -207,8 +462,11 @@ namespace splashkit_lib
         if (not quads_intersect(q1, q2))
             return false;
 
+        _cell_mask m;
+        if ( not _get_cell_mask(bmp, cell, m) ) return false;
+
         return _step_through_pixels(rect.width, rect.height, translation_matrix(rect.x, rect.y), bmp->cell_w, bmp->cell_h, translation, [&](int ax, int ay, int bx, int by)
-                                    { return pixel_drawn_at_point(bmp, cell, bx, by); });
+                                    { return _cell_pixel(m, bx, by); });
     }
 
     bool bitmap_rectangle_collision(bitmap bmp, int cell, const point_2d &pt, const rectangle &rect)
@@ -247,8 +505,11 @@ namespace splashkit_lib
         if (not quads_intersect(q1, q2))
             return false;
 
+        _cell_mask m;
+        if ( not _get_cell_mask(bmp, cell, m) ) return false;
+
         return _step_through_pixels(rect.width, rect.height, translation_matrix(rect.x, rect.y), bmp->cell_w, bmp->cell_h, translation, [&](int ax, int ay, int bx, int by)
-                                    { return pixel_drawn_at_point(bmp, cell, bx, by) && point_in_circle(point_at(rect.x + ax, rect.y + ay), circ); });
+                                    { return _cell_pixel(m, bx, by) && point_in_circle(point_at(rect.x + ax, rect.y + ay), circ); });
     }
 
     bool bitmap_circle_collision(bitmap bmp, int cell, const point_2d &pt, const circle &circ)
@@ -307,14 +568,23 @@ namespace splashkit_lib
         {
             return false;
         }
-        else if (bitmap_cell_count(sprite_collision_bitmap(s)) > 1)
-        {
-            return bitmap_point_collision(sprite_collision_bitmap(s), sprite_current_cell(s), sprite_location_matrix(s), pt);
-        }
-        else
+
+        bitmap bmp = sprite_collision_bitmap(s);
+        if (INVALID_PTR(bmp, BITMAP_PTR))
         {
-            return bitmap_point_collision(sprite_collision_bitmap(s), sprite_location_matrix(s), pt);
+            return false;
         }
+
+        _cell_mask m;
+        if ( not _get_cell_mask(bmp, bitmap_cell_count(bmp) > 1 ? sprite_current_cell(s) : 0, m) ) return false;
+
+        // The sprite's cached inverse takes the point straight to its pixel.
+        // Floor, so points just before the left or top edge miss.
+        point_2d local = matrix_multiply(sprite_location_matrix_inverse(s), pt);
+        int x = static_cast<int>(floor(local.x));
+        int y = static_cast<int>(floor(local.y));
+
+        return 0 <= x and x < bmp->cell_w and 0 <= y and y < bmp->cell_h and _cell_pixel(m, x, y);
     }
 
     bool sprite_rectangle_collision(sprite s, const rectangle &rect)
@@ -15,10 +15,16 @@
 
 #include "graphics_driver.h"
 #include "core_driver.h"
+#include "utils_driver.h"
 
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <cmath>
 
 using std::map;
+using std::vector;
+using std::sort;
 using std::to_string;
 
 namespace splashkit_lib
@@ -26,7 +32,18 @@ namespace splashkit_lib
     extern map<string, window> _windows;
     extern window _current_window;
 
-    static unsigned int _last_update_time = 0;
+    // Frame pacing: the time the next frame is due, and the time the last
+    // frame was shown, both in performance counter units.
+    static uint64_t _next_frame_due = 0;
+    static uint64_t _last_frame_time = 0;
+
+    // Rolling record of the most recent frame times, used for statistics.
+    #define FRAME_SAMPLES 240
+    static double _frame_times[FRAME_SAMPLES];     // ms between frames
+    static double _frame_errors[FRAME_SAMPLES];    // ms away from target
+    static int _frame_sample_count = 0;
+    static int _next_frame_sample = 0;
+    static int _dropped_frames = 0;
 
     void refresh_screen()
     {
@@ -36,25 +53,93 @@ namespace splashkit_lib
         }
     }
 
+    static void _record_frame(uint64_t now, uint64_t period, uint64_t freq)
+    {
+        if ( _last_frame_time != 0 )
+        {
+            double frame_ms = (now - _last_frame_time) * 1000.0 / freq;
+            double target_ms = period * 1000.0 / freq;
+
+            _frame_times[_next_frame_sample] = frame_ms;
+            _frame_errors[_next_frame_sample] = fabs(frame_ms - target_ms);
+            _next_frame_sample = (_next_frame_sample + 1) % FRAME_SAMPLES;
+            if ( _frame_sample_count < FRAME_SAMPLES ) _frame_sample_count++;
+        }
+
+        _last_frame_time = now;
+    }
+
     void delay_for_target_fps(unsigned int target_fps)
     {
         if ( target_fps == 0 ) return;
-        unsigned int now = current_ticks();
-        unsigned int delta = now - _last_update_time;
-        unsigned int delay_time;
-        
-        //dont sleep if 5ms remaining...
-        while ((target_fps > 0) and ((delta + 8) * target_fps < 1000))
+
+        uint64_t freq = sk_performance_frequency();
+        uint64_t period = freq / target_fps;
+        uint64_t now = sk_performance_counter();
+
+        if ( _next_frame_due == 0 or now > _next_frame_due + period )
         {
-            delay_time = (1000 / target_fps) - delta;
-            delay(delay_time);
-            now = current_ticks();
-            delta = now - _last_update_time;
+            // More than a frame behind... count the missed frames and pace
+            // from now, rather than rushing frames out to catch up.
+            if ( _next_frame_due != 0 )
+                _dropped_frames += static_cast<int>((now - _next_frame_due) / period);
+            _next_frame_due = now;
         }
-        
-        _last_update_time = now;
+        else if ( now < _next_frame_due )
+        {
+            sk_wait_until(_next_frame_due);
+            now = sk_performance_counter();
+        }
+
+        _record_frame(now, period, freq);
+
+        // Schedule from the deadline, not from now, so errors do not add up
+        _next_frame_due += period;
     }
-    
+
+    static double _frame_percentile(const vector<double> &sorted, double pct)
+    {
+        int idx = static_cast<int>(ceil(pct * sorted.size())) - 1;
+        if ( idx < 0 ) idx = 0;
+        if ( idx >= static_cast<int>(sorted.size()) ) idx = static_cast<int>(sorted.size()) - 1;
+        return sorted[idx];
+    }
+
+    frame_statistics current_frame_statistics()
+    {
+        frame_statistics result = { 0, 0.0, 0.0, 0.0, 0.0, 0.0, _dropped_frames };
+
+        if ( _frame_sample_count == 0 ) return result;
+
+        vector<double> sorted(_frame_times, _frame_times + _frame_sample_count);
+        sort(sorted.begin(), sorted.end());
+
+        double total = 0, total_error = 0;
+        for (int i = 0; i < _frame_sample_count; i++)
+        {
+            total += _frame_times[i];
+            total_error += _frame_errors[i];
+        }
+
+        result.frames = _frame_sample_count;
+        result.mean_frame_time = total / _frame_sample_count;
+        result.p50_frame_time = _frame_percentile(sorted, 0.50);
+        result.p95_frame_time = _frame_percentile(sorted, 0.95);
+        result.p99_frame_time = _frame_percentile(sorted, 0.99);
+        result.pacing_error = total_error / _frame_sample_count;
+
+        return result;
+    }
+
+    void reset_frame_statistics()
+    {
+        _frame_sample_count = 0;
+        _next_frame_sample = 0;
+        _dropped_frames = 0;
+        _last_frame_time = 0;
+        _next_frame_due = 0;
+    }
+
     void refresh_screen(unsigned int target_fps)
     {
         refresh_screen();
@@ -71,6 +156,21 @@ namespace splashkit_lib
         clear_window(_current_window, COLOR_WHITE);
     }
 
+    void set_deferred_drawing(bool deferred)
+    {
+        sk_set_deferred_drawing(deferred);
+    }
+
+    bool deferred_drawing()
+    {
+        return sk_deferred_drawing();
+    }
+
+    void flush_deferred_drawing()
+    {
+        sk_flush_all_drawing();
+    }
+
     int screen_width()
     {
         return window_width(current_window());
@@ -81,7 +181,7 @@ namespace splashkit_lib
         return window_height(current_window());
     }
 
-    void _save_surface(image_data &image, string basename)
+    void _save_surface(image_data &image, string basename, bool in_background = false)
     {
         string path = path_from( {path_to_user_home(), "Desktop"} );
 
@@ -102,7 +202,20 @@ namespace splashkit_lib
 
         path = path_from( { path }, filename);
 
-        sk_save_png(&image.surface, path.c_str());
+        if ( in_background )
+        {
+            std::shared_future<bool> saved = sk_save_png_async(&image.surface, path.c_str());
+
+            // Failing to open the file is known straight away
+            if ( saved.wait_for(std::chrono::seconds(0)) == std::future_status::ready and not saved.get() )
+            {
+                LOG(WARNING) << "Unable to save image to " << path;
+            }
+        }
+        else
+        {
+            sk_save_png(&image.surface, path.c_str());
+        }
     }
 
     void take_screenshot(const string &basename)
@@ -132,6 +245,54 @@ namespace splashkit_lib
         _save_surface(bmp->image, basename);
     }
 
+    void take_screenshot_in_background(const string &basename)
+    {
+        take_screenshot_in_background(current_window(), basename);
+    }
+
+    void take_screenshot_in_background(window wind, const string &basename)
+    {
+        if ( INVALID_PTR(wind, WINDOW_PTR))
+        {
+            LOG(WARNING) << "Attempting to save screenshot of invalid window";
+            return;
+        }
+
+        _save_surface(wind->image, basename, true);
+    }
+
+    void save_bitmap_in_background(bitmap bmp, const string &basename)
+    {
+        if ( INVALID_PTR(bmp, BITMAP_PTR))
+        {
+            LOG(WARNING) << "Attempting to save image of invalid bitmap";
+            return;
+        }
+
+        _save_surface(bmp->image, basename, true);
+    }
+
+    int images_being_saved()
+    {
+        return static_cast<int>(sk_png_saves_pending());
+    }
+
+    void wait_for_images_to_save()
+    {
+        sk_wait_for_png_saves();
+    }
+
+    void set_headless(bool headless)
+    {
+        sk_set_headless(headless);
+    }
+
+    bool is_headless()
+    {
+        internal_sk_init();
+        return sk_headless();
+    }
+
     int number_of_displays()
     {
         sk_system_data *data = sk_read_system_data();
@@ -48,6 +48,21 @@ namespace splashkit_lib
      */
     void refresh_screen(unsigned int target_fps);
 
+    /**
+     * Returns statistics on how closely recent frames have kept to the target
+     * frame rate passed to `refresh_screen` or `refresh_window`. Use this to
+     * check for frame time spikes and dropped frames in your game loop.
+     *
+     * @return The frame statistics for the most recent frames.
+     */
+    frame_statistics current_frame_statistics();
+
+    /**
+     * Discards the recorded frame times and dropped frame count, so that
+     * `current_frame_statistics` only covers frames from this point on.
+     */
+    void reset_frame_statistics();
+
     /**
      * When called, all open windows will have their contents removed and will be
      * redrawn with a background color set to the `clr` that was provided.
@@ -68,6 +83,37 @@ namespace splashkit_lib
      */
     void clear_screen();
 
+    /**
+     * Turns deferred drawing on or off. When drawing is deferred, filled
+     * shapes, pixels and lines are collected for each window and bitmap and
+     * are then drawn together in one batch. This makes drawing thousands of
+     * small shapes each frame much faster.
+     *
+     * Batches are drawn automatically when they are needed: when the window
+     * is refreshed, when the bitmap is drawn or read, when the clip area
+     * changes, or when something that cannot be deferred (like text or
+     * bitmaps) is drawn onto the same destination. Turning deferred drawing
+     * off will draw any batches that are waiting.
+     *
+     * @param deferred Pass in `true` to defer drawing, or `false` to draw
+     *                 each shape as it is requested.
+     */
+    void set_deferred_drawing(bool deferred);
+
+    /**
+     * Indicates if drawing is currently being deferred and batched.
+     *
+     * @return true if drawing is being deferred.
+     */
+    bool deferred_drawing();
+
+    /**
+     * Draws any deferred drawing that is waiting on all windows and
+     * bitmaps. This is only needed when you read from the screen using a
+     * means outside of SplashKit.
+     */
+    void flush_deferred_drawing();
+
     /**
      * Returns the width of the current window.
      *
@@ -115,6 +161,81 @@ namespace splashkit_lib
      */
     void save_bitmap(bitmap bmp, const string &basename);
 
+    /**
+     *  Saves a screenshot of the current window in the background. The pixels
+     *  are captured straight away, but the png is compressed and written by
+     *  other threads, so this does not hold up your program. Use this to save
+     *  screenshots each frame. If too many images are waiting to be written
+     *  this will wait for one of them to finish.
+     *
+     * @param basename The base of the filename. If there is a file of this name
+     *                 already, then the name will be changed to generate a
+     *                 unique filename.
+     */
+    void take_screenshot_in_background(const string &basename);
+
+    /**
+     *  Saves a screenshot of the window in the background. The pixels are
+     *  captured straight away, but the png is compressed and written by other
+     *  threads, so this does not hold up your program.
+     *
+     * @param wind     The window to capture in the screenshot
+     * @param basename The base of the filename. If there is a file of this name
+     *                 already, then the name will be changed to generate a
+     *                 unique filename.
+     *
+     * @attribute suffix  of_window
+     */
+    void take_screenshot_in_background(window wind, const string &basename);
+
+    /**
+     * Save the bitmap to the user's desktop in the background. The pixels are
+     * captured straight away, but the png is compressed and written by other
+     * threads.
+     *
+     * @param bmp      The bitmap to save
+     * @param basename The base of the filename. If there is a file of this name
+     *                 already, then the name will be changed to generate a
+     *                 unique filename.
+     */
+    void save_bitmap_in_background(bitmap bmp, const string &basename);
+
+    /**
+     * Returns the number of images saved in the background that are still
+     * being written.
+     *
+     * @return The number of images waiting to be written
+     */
+    int images_being_saved();
+
+    /**
+     * Waits until all of the images being saved in the background have been
+     * written.
+     */
+    void wait_for_images_to_save();
+
+    /**
+     * Choose whether SplashKit runs headless. Headless windows and bitmaps are
+     * drawn in memory using software rendering, without connecting to a
+     * display, so programs can render and save images on servers and build
+     * machines. Drawing, reading pixels and saving images work as normal, but
+     * nothing is shown on screen and there are no displays.
+     *
+     * This must be called before any other SplashKit call. Setting the
+     * `SPLASHKIT_HEADLESS` environment variable to `1` also selects headless
+     * mode.
+     *
+     * @param headless Pass in `true` to run without a display.
+     */
+    void set_headless(bool headless);
+
+    /**
+     * Indicates if SplashKit is running headless, without a display.
+     *
+     * @return true if windows and bitmaps are only drawn in memory.
+     */
+    bool is_headless();
+
     /**
      * Returns the number of physical displays attached to the computer.
      *
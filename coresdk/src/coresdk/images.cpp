@@ -9,21 +9,40 @@
 #include "images.h"
 
 #include "graphics_driver.h"
+#include "collision_mask.h"
 #include "backend_types.h"
 #include "utility_functions.h"
 #include "resources.h"
 
+#include <algorithm>
 #include <map>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 
 using std::map;
+using std::vector;
 using std::to_string;
 
 namespace splashkit_lib
 {
     static map<string, bitmap> _bitmaps;
 
+    // Changes each time a bitmap's cell details change, so sprites can tell
+    // when their cached sizes are out of date
+    unsigned int _bitmap_cell_details_version = 0;
+
+    // Defined with the render queue below
+    static void _remove_queued_bitmaps(bitmap bmp);
+
+    // Work out the opaque area of each cell, used to skip empty space in collisions
+    static void _update_mask_cells(bitmap bmp)
+    {
+        if ( bmp->pixel_mask == nullptr ) return;
+
+        update_collision_mask_cells(bmp->pixel_mask, bmp->cell_w, bmp->cell_h, bmp->cell_cols, bmp->cell_count);
+    }
+
     void setup_collision_mask(bitmap bmp)
     {
         if ( INVALID_PTR(bmp, BITMAP_PTR) )
@@ -34,7 +53,6 @@ namespace splashkit_lib
         
         int *pixels;
         int sz;
-        int r, c;
 
         sz = bmp->image.surface.width * bmp->image.surface.height;
         pixels = (int *) malloc(sizeof(int) * sz);
@@ -42,19 +60,10 @@ namespace splashkit_lib
         sk_to_pixels(&bmp->image.surface, pixels, sz);
 
         if ( bmp->pixel_mask == nullptr )
-            bmp->pixel_mask = (bool *) malloc( sizeof(bool) * sz );
+            bmp->pixel_mask = create_collision_mask(bmp->image.surface.width, bmp->image.surface.height);
 
-        // WriteLn(bmp^.name);
-        for (r = 0; r < bmp->image.surface.height; r++)
-        {
-            for(c = 0; c < bmp->image.surface.width; c++)
-            {
-                bmp->pixel_mask[c + r * bmp->image.surface.width] = ((pixels[c + r * bmp->image.surface.width] & 0x000000FF) > 0x0000007F );
-                // if b^.nonTransparentPixels[c, r] then Write(1) else Write(0);
-            }
-            // WriteLn();
-        }
-        // WriteLn();
+        fill_collision_mask(bmp->pixel_mask, pixels);
+        _update_mask_cells(bmp);
 
         free(pixels);
     }
@@ -80,14 +89,10 @@ namespace splashkit_lib
     }
 
 
-    bitmap load_bitmap(string name, string filename)
+    // Find the file for a bitmap, either as given or in the image resources
+    bool _locate_bitmap_file(const string &name, const string &filename, string &file_path)
     {
-        if (has_bitmap(name)) return bitmap_named(name);
-
-        sk_drawing_surface surface;
-        bitmap result = nullptr;
-
-        string file_path = filename;
+        file_path = filename;
 
         if ( ! file_exists(file_path) )
         {
@@ -96,18 +101,17 @@ namespace splashkit_lib
             if ( ! file_exists(file_path) )
             {
                 LOG(WARNING) << cat({ "Unable to locate file for ", name, " (", file_path, ")"});
-                return nullptr;
+                return false;
             }
         }
 
-        surface = sk_load_bitmap(file_path.c_str());
-        if ( not surface._data )
-        {
-            LOG(WARNING) <<  cat({ "Error loading image for ", name, " (", file_path, ")"}) ;
-            return nullptr;
-        }
+        return true;
+    }
 
-        result = new _bitmap_data;
+    // Wrap a loaded surface and its collision mask in a new bitmap
+    static bitmap _add_loaded_bitmap(const string &name, const string &file_path, sk_drawing_surface surface, _collision_mask *mask)
+    {
+        bitmap result = new _bitmap_data;
         result->image.surface = surface;
 
         result->id         = BITMAP_PTR;
@@ -116,18 +120,133 @@ namespace splashkit_lib
         result->cell_cols  = 1;
         result->cell_rows  = 1;
         result->cell_count = 1;
-        result->pixel_mask = nullptr;
+        result->pixel_mask = mask;
 
         result->name       = name;
         result->filename   = file_path;
 
-        setup_collision_mask(result);
+        _update_mask_cells(result);
 
         _bitmaps[name] = result;
 
         return result;
     }
 
+    // Decode an image file and build its collision mask. Safe to call from
+    // a worker thread. Returns the mask, or nullptr if the decode failed.
+    _collision_mask *_decode_bitmap_file(const string &file_path, sk_decoded_bitmap *image)
+    {
+        *image = sk_decode_bitmap(file_path.c_str());
+
+        const int *pixels = sk_decoded_pixels(image);
+        if ( ! pixels ) return nullptr;
+
+        _collision_mask *mask = create_collision_mask(image->width, image->height);
+        fill_collision_mask(mask, pixels);
+        return mask;
+    }
+
+    // Upload an image decoded off the main thread and register it as a
+    // bitmap. Takes ownership of the decoded pixels and the mask.
+    bitmap _add_decoded_bitmap(const string &name, const string &file_path, sk_decoded_bitmap *image, _collision_mask *mask)
+    {
+        if ( ! image->_data )
+        {
+            LOG(WARNING) <<  cat({ "Error loading image for ", name, " (", file_path, ")"}) ;
+            free_collision_mask(mask);
+            return nullptr;
+        }
+
+        sk_drawing_surface surface = sk_load_decoded_bitmap(image);
+        return _add_loaded_bitmap(name, file_path, surface, mask);
+    }
+
+    bitmap load_bitmap(string name, string filename)
+    {
+        if (has_bitmap(name)) return bitmap_named(name);
+
+        sk_drawing_surface surface;
+        bitmap result = nullptr;
+
+        string file_path;
+
+        if ( ! _locate_bitmap_file(name, filename, file_path) ) return nullptr;
+
+        surface = sk_load_bitmap(file_path.c_str());
+        if ( not surface._data )
+        {
+            LOG(WARNING) <<  cat({ "Error loading image for ", name, " (", file_path, ")"}) ;
+            return nullptr;
+        }
+
+        result = _add_loaded_bitmap(name, file_path, surface, nullptr);
+
+        setup_collision_mask(result);
+
+        return result;
+    }
+
+    // A bitmap being decoded by load_bitmaps
+    struct _bitmap_load_job
+    {
+        string name;
+        string file_path;
+        sk_decoded_bitmap image;
+        _collision_mask *mask;
+    };
+
+    void load_bitmaps(const vector<string> &names, const vector<string> &filenames)
+    {
+        if ( names.size() != filenames.size() )
+        {
+            LOG(WARNING) << "Attempting to load bitmaps with a different number of names and filenames";
+            return;
+        }
+
+        vector<_bitmap_load_job> jobs;
+
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if ( has_bitmap(names[i]) ) continue;
+
+            bool duplicate = false;
+            for (const _bitmap_load_job &job : jobs)
+                if ( job.name == names[i] ) duplicate = true;
+            if ( duplicate ) continue;
+
+            _bitmap_load_job job;
+            job.name = names[i];
+            job.image = { 0, 0, nullptr };
+            job.mask = nullptr;
+
+            if ( _locate_bitmap_file(names[i], filenames[i], job.file_path) )
+                jobs.push_back(job);
+        }
+
+        if ( jobs.size() == 0 ) return;
+
+        sk_init_image_decoding();
+
+        // Workers decode images and build their masks, passing the index of
+        // each finished job back so its texture can be uploaded here
+        channel<size_t> done;
+
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            shared_worker_pool().run([&jobs, &done, i]()
+            {
+                jobs[i].mask = _decode_bitmap_file(jobs[i].file_path, &jobs[i].image);
+                done.put(i);
+            });
+        }
+
+        for (size_t n = 0; n < jobs.size(); n++)
+        {
+            _bitmap_load_job &job = jobs[done.take()];
+            _add_decoded_bitmap(job.name, job.file_path, &job.image, job.mask);
+        }
+    }
+
     bitmap create_bitmap(string name, int width, int height)
     {
         bitmap result = new(_bitmap_data);
@@ -166,10 +285,10 @@ namespace splashkit_lib
             notify_of_free(bmp);
 
             _bitmaps.erase(bmp->name);
+            _remove_queued_bitmaps(bmp);
             sk_close_drawing_surface(&bmp->image.surface);
             bmp->id = NONE_PTR;  // ensure future use of this pointer will fail...
-            if ( bmp->pixel_mask != nullptr )
-                free(bmp->pixel_mask);
+            free_collision_mask(bmp->pixel_mask);
             delete(bmp);
         }
         else
@@ -219,21 +338,12 @@ namespace splashkit_lib
         draw_bitmap(bmp, x, y, option_defaults());
     }
 
-    void draw_bitmap(bitmap bmp, double x, double y, drawing_options opts)
+    //
+    // Work out the source and destination details sk_draw_bitmap needs to
+    // draw bmp at x, y with the given options.
+    //
+    static sk_drawing_surface *_bitmap_draw_data(bitmap bmp, double x, double y, const drawing_options &opts, double src_data[4], double dst_data[7], sk_renderer_flip &flip)
     {
-        if ( INVALID_PTR(bmp, BITMAP_PTR))
-        {
-            LOG(WARNING) << "Error trying to draw bitmap: passed in bmp is an invalid bitmap pointer.";
-            return;
-        }
-
-        double src_data[4];
-        double dst_data[7];
-        sk_renderer_flip flip;
-        sk_drawing_surface * dest;
-        
-        
-
         if ( VALID_PTR(opts.anim, ANIMATION_PTR) || opts.draw_cell >= 0 )
         {
             int cell;
@@ -284,7 +394,23 @@ namespace splashkit_lib
 
         xy_from_opts(opts, dst_data[0], dst_data[1]); // Camera?
 
-        dest = to_surface_ptr(opts.dest);
+        return to_surface_ptr(opts.dest);
+    }
+
+    void draw_bitmap(bitmap bmp, double x, double y, drawing_options opts)
+    {
+        if ( INVALID_PTR(bmp, BITMAP_PTR))
+        {
+            LOG(WARNING) << "Error trying to draw bitmap: passed in bmp is an invalid bitmap pointer.";
+            return;
+        }
+
+        double src_data[4];
+        double dst_data[7];
+        sk_renderer_flip flip;
+        sk_drawing_surface * dest;
+
+        dest = _bitmap_draw_data(bmp, x, y, opts, src_data, dst_data, flip);
         sk_draw_bitmap(&bmp->image.surface, dest, src_data, 4, dst_data, 7, flip);
     }
 
@@ -440,6 +566,9 @@ namespace splashkit_lib
         bmp->cell_cols  = columns;
         bmp->cell_rows  = rows;
         bmp->cell_count = count;
+
+        _update_mask_cells(bmp);
+        _bitmap_cell_details_version++;
     }
 
     int bitmap_width(bitmap bmp)
@@ -524,7 +653,7 @@ namespace splashkit_lib
 
         if ( INVALID_PTR(bmp, BITMAP_PTR) or px < 0 or px >= bitmap_width(bmp) or py < 0 or py >= bitmap_height(bmp) or bmp->pixel_mask == nullptr ) return false;
 
-        return bmp->pixel_mask[px + py * bmp->image.surface.width];
+        return collision_mask_pixel(bmp->pixel_mask, px, py);
     }
 
     bool pixel_drawn_at_point(bitmap bmp, int cell, double x, double y)
@@ -542,4 +671,125 @@ namespace splashkit_lib
     {
         return pixel_drawn_at_point(bmp, cell, pt.x, pt.y);
     }
+
+    //---------------------------------------------------------------------------
+    // Render queue
+    //---------------------------------------------------------------------------
+
+    struct _queued_bitmap
+    {
+        int     layer;
+        int     order;      // keeps the layers of a sprite in order within a queue layer
+        bitmap  bmp;
+        void    *dest;
+        double  data[12];   // src_data, dst_data and flip, as sk_draw_bitmap_quads expects
+    };
+
+    static vector<_queued_bitmap> _render_queue;
+
+    void queue_bitmap(bitmap bmp, double x, double y, int layer)
+    {
+        queue_bitmap(bmp, x, y, layer, option_defaults());
+    }
+
+    // Queue a bitmap that must be drawn after those with a lower order in
+    // the same layer, such as the layers of a sprite
+    void _queue_bitmap(bitmap bmp, double x, double y, int layer, int order, drawing_options opts)
+    {
+        if ( INVALID_PTR(bmp, BITMAP_PTR))
+        {
+            LOG(WARNING) << "Error trying to queue bitmap: passed in bmp is an invalid bitmap pointer.";
+            return;
+        }
+
+        _queued_bitmap item;
+        sk_renderer_flip flip;
+
+        item.layer = layer;
+        item.order = order;
+        item.bmp = bmp;
+        item.dest = opts.dest;
+        _bitmap_draw_data(bmp, x, y, opts, item.data, item.data + 4, flip);
+        item.data[11] = flip;
+
+        _render_queue.push_back(item);
+    }
+
+    void queue_bitmap(bitmap bmp, double x, double y, int layer, drawing_options opts)
+    {
+        _queue_bitmap(bmp, x, y, layer, 0, opts);
+    }
+
+    void draw_render_queue()
+    {
+        // Lower layers first, then group draws with the same destination and
+        // bitmap so that each group is drawn in one batch. The order keeps
+        // sprite overlays above their base layer.
+        std::stable_sort(_render_queue.begin(), _render_queue.end(), [](const _queued_bitmap &a, const _queued_bitmap &b)
+        {
+            if ( a.layer != b.layer ) return a.layer < b.layer;
+            if ( a.order != b.order ) return a.order < b.order;
+            if ( a.dest != b.dest ) return a.dest < b.dest;
+            return a.bmp < b.bmp;
+        });
+
+        // Reused between calls, so repeated frames do not allocate
+        static vector<double> quads;
+
+        size_t start = 0;
+        while ( start < _render_queue.size() )
+        {
+            const _queued_bitmap &first = _render_queue[start];
+            size_t end = start + 1;
+
+            while ( end < _render_queue.size() and _render_queue[end].layer == first.layer and
+                    _render_queue[end].order == first.order and _render_queue[end].dest == first.dest and _render_queue[end].bmp == first.bmp )
+            {
+                end++;
+            }
+
+            quads.clear();
+            for (size_t i = start; i < end; i++)
+            {
+                quads.insert(quads.end(), _render_queue[i].data, _render_queue[i].data + 12);
+            }
+
+            sk_draw_bitmap_quads(&first.bmp->image.surface, to_surface_ptr(first.dest), quads.data(), static_cast<int>(end - start));
+            start = end;
+        }
+
+        _render_queue.clear();
+    }
+
+    void clear_render_queue()
+    {
+        _render_queue.clear();
+    }
+
+    int render_queue_size()
+    {
+        return static_cast<int>(_render_queue.size());
+    }
+
+    //
+    // Forget queued draws of, or onto, a bitmap that is being freed.
+    //
+    static void _remove_queued_bitmaps(bitmap bmp)
+    {
+        _render_queue.erase(std::remove_if(_render_queue.begin(), _render_queue.end(), [bmp](const _queued_bitmap &item)
+        {
+            return item.bmp == bmp or item.dest == bmp;
+        }), _render_queue.end());
+    }
+
+    //
+    // Forget queued draws onto a window that is being closed.
+    //
+    void _remove_queued_draws_onto(void *dest)
+    {
+        _render_queue.erase(std::remove_if(_render_queue.begin(), _render_queue.end(), [dest](const _queued_bitmap &item)
+        {
+            return item.dest == dest;
+        }), _render_queue.end());
+    }
 }
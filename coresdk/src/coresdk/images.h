@@ -15,7 +15,9 @@
 #include "physics.h"
 
 #include <string>
+#include <vector>
 using std::string;
+using std::vector;
 
 namespace splashkit_lib
 {
@@ -34,6 +36,18 @@ namespace splashkit_lib
      */
     bitmap load_bitmap(string name, string filename);
 
+    /**
+     * Loads a number of bitmaps at once. Each image is decoded and has its
+     * collision mask built on a separate thread, so this is much faster than
+     * calling `load_bitmap` for each image when there are many to load. This
+     * returns once all of the bitmaps are loaded and ready to draw. Each bitmap
+     * can then be retrieved by passing its name to `bitmap_named`.
+     *
+     * @param names     The names of the bitmap resources in SplashKit
+     * @param filenames The filenames to load, one for each name
+     */
+    void load_bitmaps(const vector<string> &names, const vector<string> &filenames);
+
     /**
      * Determines if SplashKit has a bitmap loaded for the supplied name.
      * This checks against all bitmaps loaded.
@@ -627,5 +641,68 @@ namespace splashkit_lib
      * @attribute method pixel_drawn_at_point_in_cell
      */
     bool pixel_drawn_at_point(bitmap bmp, int cell, const point_2d &pt);
+
+    //---------------------------------------------------------------------------
+    // Render queue
+    //---------------------------------------------------------------------------
+
+    /**
+     * Adds the bitmap to the render queue, to be drawn to the current window
+     * at `x` and `y` when `draw_render_queue` is called. Queued bitmaps are
+     * drawn in order of their layer, lowest first. Within a layer, copies of
+     * the same bitmap are drawn together in a single batch, which is much
+     * faster than drawing each one with `draw_bitmap`.
+     *
+     * @param bmp   The bitmap to queue
+     * @param x     The x location to draw the bitmap
+     * @param y     The y location to draw the bitmap
+     * @param layer The layer to draw the bitmap in, higher layers are
+     *              drawn on top of lower layers
+     *
+     * @attribute class   bitmap
+     * @attribute method  queue
+     * @attribute self    bmp
+     */
+    void queue_bitmap(bitmap bmp, double x, double y, int layer);
+
+    /**
+     * Adds the bitmap to the render queue, to be drawn with the supplied
+     * options when `draw_render_queue` is called. The position of the camera
+     * is taken into account when the bitmap is queued.
+     *
+     * @param bmp   The bitmap to queue
+     * @param x     The x location to draw the bitmap
+     * @param y     The y location to draw the bitmap
+     * @param layer The layer to draw the bitmap in, higher layers are
+     *              drawn on top of lower layers
+     * @param opts  The `drawing_options` which provide extra information
+     *              for how to draw the `bitmap`
+     *
+     * @attribute class   bitmap
+     * @attribute method  queue
+     * @attribute self    bmp
+     * @attribute suffix  with_options
+     */
+    void queue_bitmap(bitmap bmp, double x, double y, int layer, drawing_options opts);
+
+    /**
+     * Draws everything in the render queue, and then empties the queue. The
+     * queue is sorted by layer, and then by bitmap, so that consecutive
+     * draws of the same bitmap can be drawn in a single batch. Call this
+     * before refreshing the screen.
+     */
+    void draw_render_queue();
+
+    /**
+     * Empties the render queue without drawing anything.
+     */
+    void clear_render_queue();
+
+    /**
+     * Returns the number of bitmaps waiting to be drawn in the render queue.
+     *
+     * @returns The number of queued bitmaps.
+     */
+    int render_queue_size();
 }
 #endif /* images_h */
@@ -52,6 +52,40 @@ namespace splashkit_lib
     {
         draw_line(clr, l.start_point.x, l.start_point.y, l.end_point.x, l.end_point.y, opts);
     }
+
+    void draw_lines(const vector<color> &clrs, const vector<line> &lines, drawing_options opts)
+    {
+        if ( lines.empty() ) return;
+
+        sk_drawing_surface *surface = to_surface_ptr(opts.dest);
+        const color *instance_clrs = instance_colors(clrs, lines.size());
+
+        if ( not surface or not instance_clrs ) return;
+
+        // 4 values per line, reused between calls
+        static vector<double> data;
+        data.resize(lines.size() * 4);
+
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            double x1 = lines[i].start_point.x, y1 = lines[i].start_point.y;
+            double x2 = lines[i].end_point.x, y2 = lines[i].end_point.y;
+            xy_from_opts(opts, x1, y1);
+            xy_from_opts(opts, x2, y2);
+
+            data[i * 4] = x1;
+            data[i * 4 + 1] = y1;
+            data[i * 4 + 2] = x2;
+            data[i * 4 + 3] = y2;
+        }
+
+        sk_draw_lines(surface, instance_clrs, data.data(), static_cast<int>(lines.size()), opts.line_width);
+    }
+
+    void draw_lines(const vector<color> &clrs, const vector<line> &lines)
+    {
+        draw_lines(clrs, lines, option_defaults());
+    }
     
     void draw_line_on_window(window destination, color clr, double x1, double y1, double x2, double y2)
     {
@@ -88,6 +88,28 @@ namespace splashkit_lib
      * @attribute suffix  record_with_options
      */
     void draw_line(color clr, const line &l, drawing_options opts);
+
+    /**
+     * Draws a number of lines in one go. This is much faster than calling
+     * `draw_line` for each line. All of the lines use the line width from the
+     * drawing options.
+     *
+     * @param clrs  The color of each line, or a single color for them all
+     * @param lines The lines to draw
+     * @param opts  The drawing options
+     *
+     * @attribute suffix  with_options
+     */
+    void draw_lines(const vector<color> &clrs, const vector<line> &lines, drawing_options opts);
+
+    /**
+     * Draws a number of lines on the current window in one go. This is much
+     * faster than calling `draw_line` for each line.
+     *
+     * @param clrs  The color of each line, or a single color for them all
+     * @param lines The lines to draw
+     */
+    void draw_lines(const vector<color> &clrs, const vector<line> &lines);
     
     /**
      * Draw a line from one point to another on the given window.
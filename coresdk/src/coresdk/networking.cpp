@@ -7,6 +7,7 @@
 #include "networking.h"
 #include "network_driver.h"
 #include "utility_functions.h"
+#include "object_pool.h"
 
 using std::endl;
 using std::stringstream;
@@ -28,6 +29,7 @@ namespace splashkit_lib
     static map<string, connection> _connections;
     static map<string, server_socket> _server_sockets;
     static vector<message> _messages;
+    static object_pool<sk_message> _message_pool;
 
     server_socket create_server(const string &name, unsigned short int port, connection_type protocol)
     {
@@ -545,7 +547,7 @@ namespace splashkit_lib
 
     void _enqueue_tcp_message(const vector<int8_t> &message, connection con)
     {
-        sk_message* m = new sk_message;
+        sk_message* m = _message_pool.allocate();
 
         m->id = MESSAGE_PTR;
         m->data = message;
@@ -561,7 +563,7 @@ namespace splashkit_lib
 
     void _enqueue_udp_message(vector<sk_message*> &messages, const char* msg, unsigned long size, unsigned int host, int port)
     {
-        message m = new sk_message;
+        message m = _message_pool.allocate();
         m->id = MESSAGE_PTR;
         for (int i = 0; i < size; ++i)
         {
@@ -835,8 +837,12 @@ namespace splashkit_lib
             return;
         }
 
-        msg->id = NONE_PTR;
-        delete msg;
+        _message_pool.release(msg);
+    }
+
+    pool_statistics message_pool_statistics()
+    {
+        return _message_pool.statistics();
     }
 
     bool has_messages()
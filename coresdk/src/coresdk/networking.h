@@ -551,6 +551,15 @@ namespace splashkit_lib
      */
     void close_message(message msg);
 
+    /**
+     * Returns statistics on the pooled storage used for received messages.
+     * Closed messages return their storage to the pool, where it is reused
+     * by the next message received.
+     *
+     * @returns The current message pool statistics.
+     */
+    pool_statistics message_pool_statistics();
+
     /**
      * Checks if there are any messages waiting to be read.
      *
@@ -104,6 +104,52 @@ namespace splashkit_lib
         fill_rectangle(clr, rect.x, rect.y, rect.width, rect.height, option_defaults());
     }
 
+    void fill_rectangles(const vector<color> &clrs, const vector<rectangle> &rects, drawing_options opts)
+    {
+        if ( rects.empty() ) return;
+
+        sk_drawing_surface *surface = to_surface_ptr(opts.dest);
+        const color *instance_clrs = instance_colors(clrs, rects.size());
+
+        if ( not surface or not instance_clrs ) return;
+
+        // 4 values per rectangle, reused between calls
+        static vector<double> data;
+        data.resize(rects.size() * 4);
+
+        for (size_t i = 0; i < rects.size(); i++)
+        {
+            double x = rects[i].x, y = rects[i].y;
+            double width = rects[i].width, height = rects[i].height;
+
+            if (width < 0)
+            {
+                x = x + width; //move back by width
+                width = -width;
+            }
+
+            if (height < 0)
+            {
+                y = y + height; //move up by height
+                height = -height;
+            }
+
+            xy_from_opts(opts, x, y);
+
+            data[i * 4] = x;
+            data[i * 4 + 1] = y;
+            data[i * 4 + 2] = width;
+            data[i * 4 + 3] = height;
+        }
+
+        sk_fill_rects(surface, instance_clrs, data.data(), static_cast<int>(rects.size()));
+    }
+
+    void fill_rectangles(const vector<color> &clrs, const vector<rectangle> &rects)
+    {
+        fill_rectangles(clrs, rects, option_defaults());
+    }
+
     void draw_quad(color clr, const quad &q)
     {
         draw_quad(clr, q, option_defaults());
@@ -113,6 +113,28 @@ namespace splashkit_lib
      */
     void fill_rectangle(color clr, const rectangle &rect);
 
+    /**
+     * Fills a number of rectangles in one go. This is much faster than calling
+     * `fill_rectangle` for each rectangle, so use this when drawing lots of
+     * tiles or other small shapes.
+     *
+     * @param clrs    The color of each rectangle, or a single color for them all
+     * @param rects   The rectangles to fill
+     * @param opts    The drawing options
+     *
+     * @attribute suffix  with_options
+     */
+    void fill_rectangles(const vector<color> &clrs, const vector<rectangle> &rects, drawing_options opts);
+
+    /**
+     * Fills a number of rectangles on the current window in one go. This is
+     * much faster than calling `fill_rectangle` for each rectangle.
+     *
+     * @param clrs    The color of each rectangle, or a single color for them all
+     * @param rects   The rectangles to fill
+     */
+    void fill_rectangles(const vector<color> &clrs, const vector<rectangle> &rects);
+
     /**
      * Draw a quad to the current window.
      *
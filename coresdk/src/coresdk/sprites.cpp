@@ -13,22 +13,32 @@
 #include "geometry.h"
 #include "images.h"
 #include "mouse_input.h"
+#include "object_pool.h"
+#include "sound.h"
 #include "sprites.h"
 #include "timers.h"
 #include "utility_functions.h"
 #include "vector_2d.h"
+#include "window_manager.h"
 
+#include <algorithm>
 #include <cmath>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 using std::map;
+using std::unordered_map;
 using std::vector;
 using std::to_string;
 using std::swap;
 
 namespace splashkit_lib
 {
+    // From images.cpp
+    void _queue_bitmap(bitmap bmp, double x, double y, int layer, int order, drawing_options opts);
+    extern unsigned int _bitmap_cell_details_version;
+
     timer _sprite_timer = nullptr;
     vector<sprite_event_handler *> _global_sprite_event_handlers;
 
@@ -44,9 +54,31 @@ namespace splashkit_lib
         return _sprite_packs[_current_pack];
     }
 
+    // Broad-phase grid for each sprite pack. Sprites are bucketed into square
+    // cells by their collision rectangle, so collision, region and point
+    // queries only test sprites that share a cell.
+#define PACK_GRID_CELL_SIZE 128.0
+
+    struct _sprite_grid
+    {
+        unordered_map<int64_t, vector<sprite>> cells;
+        vector<sprite> dirty;   // Sprites moved since the grid was last refreshed
+        unsigned int cell_details_version = 0;  // Bitmap cell details the grid was built with
+    };
+
+    map<string, _sprite_grid> _pack_grids;
+
+    _sprite_grid &current_pack_grid()
+    {
+        return _pack_grids[_current_pack];
+    }
+
+// Names of the values stored in their own fields, rather than in the
+// sprite's map of custom values
 #define SCALE_KEY       "scale"
 #define ROTATION_KEY    "rotation"
 #define MASS_KEY        "mass"
+#define BUILTIN_VALUE_COUNT 3
 
     struct _sprite_data
     {
@@ -58,7 +90,21 @@ namespace splashkit_lib
         vector<int>         visible_layers;   // The indexes of the visible layers
         vector<vector_2d>   layer_offsets;    // Offsets from drawing the layers
 
-        map<string, float>  values;           // Values associated with this sprite
+        map<string, float>  values;           // Custom values associated with this sprite
+
+        float               rotation;         // Rotation of the sprite in degrees
+        float               scale;            // Scale of the sprite
+        float               mass;             // Mass used by the physics routines
+
+        bool                transform_valid;  // Are the cached transform details current?
+        unsigned int        cell_details_version; // Bitmap cell details the cached values were calculated with
+        matrix_2d           location_matrix;  // Cached result of sprite_location_matrix
+        matrix_2d           location_inverse; // Cached inverse of the location matrix
+        rectangle           collision_rect;   // Cached result of sprite_collision_rectangle
+
+        bool                draw_bounds_valid;    // Is draw_bounds current?
+        bool                draw_bounds_animated; // Was draw_bounds calculated using animation cells?
+        rectangle           draw_bounds;          // Area covered when drawn, used to cull offscreen sprites
 
 
         animation           animation_info;   // The data used to animate this sprite
@@ -86,15 +132,252 @@ namespace splashkit_lib
 
         vector<void *>      &pack;              // Points the the SpritePack that contains this sprite
 
-        _sprite_data() : pack( current_pack() )
+        _sprite_grid        &grid;              // The broad-phase grid of the sprite's pack
+        rectangle           grid_bounds;        // Collision rectangle when last placed in the grid
+        int                 grid_left, grid_top, grid_right, grid_bottom; // Grid cells occupied
+        bool                in_grid;
+        bool                grid_dirty;         // Moved since last placed in the grid
+
+        _sprite_data() : pack( current_pack() ), grid( current_pack_grid() )
         {
         }
     };
 
+    static object_pool<_sprite_data> _sprite_pool;
+
+    //-----------------------------------------------------------------------------
+    // Sprite pack grid
+    //-----------------------------------------------------------------------------
+
+    static int64_t _grid_key(int col, int row)
+    {
+        return (static_cast<int64_t>(col) << 32) | static_cast<uint32_t>(row);
+    }
+
+    static int _grid_cell(double coord)
+    {
+        return static_cast<int>(floor(coord / PACK_GRID_CELL_SIZE));
+    }
+
+    //
+    // Record that the sprite's collision rectangle may have changed. The grid
+    // is updated lazily, the next time the pack is queried.
+    //
+    static void _grid_mark_moved(sprite s)
+    {
+        if ( s->grid_dirty ) return;
+
+        s->grid_dirty = true;
+        s->grid.dirty.push_back(s);
+    }
+
+    static void _grid_remove(sprite s)
+    {
+        if ( not s->in_grid ) return;
+
+        for (int col = s->grid_left; col <= s->grid_right; col++)
+        {
+            for (int row = s->grid_top; row <= s->grid_bottom; row++)
+            {
+                auto it = s->grid.cells.find(_grid_key(col, row));
+                if ( it == s->grid.cells.end() ) continue;
+
+                erase_from_vector(it->second, s);
+                if ( it->second.empty() ) s->grid.cells.erase(it);
+            }
+        }
+
+        s->in_grid = false;
+    }
+
+    static void _grid_insert(sprite s)
+    {
+        for (int col = s->grid_left; col <= s->grid_right; col++)
+        {
+            for (int row = s->grid_top; row <= s->grid_bottom; row++)
+            {
+                s->grid.cells[_grid_key(col, row)].push_back(s);
+            }
+        }
+
+        s->in_grid = true;
+    }
+
+    //
+    // Re-bucket the sprites that have moved since the last query. Sprites that
+    // stay within the same cells only have their bounds updated.
+    //
+    static void _refresh_grid(_sprite_grid &grid)
+    {
+        // Changing a bitmap's cells changes the collision rectangles of the
+        // sprites using it, even though they have not moved
+        if ( grid.cell_details_version != _bitmap_cell_details_version )
+        {
+            grid.cell_details_version = _bitmap_cell_details_version;
+
+            for (auto &cell : grid.cells)
+            {
+                for (sprite s : cell.second)
+                {
+                    _grid_mark_moved(s);
+                }
+            }
+        }
+
+        for (sprite s : grid.dirty)
+        {
+            rectangle r = sprite_collision_rectangle(s);
+            int left = _grid_cell(r.x);
+            int top = _grid_cell(r.y);
+            int right = _grid_cell(r.x + r.width);
+            int bottom = _grid_cell(r.y + r.height);
+
+            s->grid_bounds = r;
+            s->grid_dirty = false;
+
+            if ( s->in_grid and left == s->grid_left and top == s->grid_top and right == s->grid_right and bottom == s->grid_bottom )
+                continue;
+
+            _grid_remove(s);
+            s->grid_left = left;
+            s->grid_top = top;
+            s->grid_right = right;
+            s->grid_bottom = bottom;
+            _grid_insert(s);
+        }
+
+        grid.dirty.clear();
+    }
+
+    //
+    // Order sprites by their position in the pack, so query results do not
+    // depend on the layout of the grid.
+    //
+    static void _sort_by_pack_order(const vector<void *> &pack, vector<sprite> &sprites)
+    {
+        unordered_map<sprite, size_t> order;
+        for (size_t i = 0; i < pack.size(); i++)
+            order[static_cast<sprite>(pack[i])] = i;
+
+        std::sort(sprites.begin(), sprites.end(), [&order](sprite a, sprite b) { return order[a] < order[b]; });
+    }
+
+    //
+    // The position, rotation, scale, anchor or collision bitmap of the sprite
+    // has changed -- recalculate its transform when it is next needed.
+    //
+    static void _sprite_transform_changed(sprite s)
+    {
+        s->transform_valid = false;
+        s->draw_bounds_valid = false;
+        _grid_mark_moved(s);
+    }
+
+    //
+    // The visible layers, their offsets, or the way the sprite is drawn have
+    // changed -- recalculate the area it draws to when it is next drawn.
+    //
+    static void _sprite_layers_changed(sprite s)
+    {
+        s->draw_bounds_valid = false;
+    }
+
+    //
+    // The cached transform and draw bounds use the sizes of the sprite's
+    // cells -- recalculate them if any bitmap's cell details have changed.
+    //
+    static void _check_sprite_cell_details(sprite s)
+    {
+        if ( s->cell_details_version == _bitmap_cell_details_version ) return;
+
+        s->cell_details_version = _bitmap_cell_details_version;
+        _sprite_transform_changed(s);
+    }
+
+    static void _update_sprite_transform(sprite s)
+    {
+        matrix_2d result = identity_matrix();
+
+        float scale = s->scale;
+        float w = sprite_layer_width(s, 0);
+        float h = sprite_layer_height(s, 0);
+
+        matrix_2d anchor_matrix = translation_matrix(s->anchor_point);
+
+        result = matrix_multiply(result, matrix_inverse(anchor_matrix));
+        result = matrix_multiply(result, rotation_matrix(s->rotation));
+        result = matrix_multiply(result, anchor_matrix);
+
+        float new_x = s->position.x - (w * scale / 2.0) + (w / 2.0);
+        float new_y = s->position.y - (h * scale / 2.0) + (h / 2.0);
+        result = matrix_multiply(result, translation_matrix(new_x / scale, new_y / scale));
+
+        s->location_matrix = matrix_multiply(result, scale_matrix(scale));
+        s->location_inverse = matrix_inverse(s->location_matrix);
+
+        if ( s->rotation == 0 and s->scale == 1 )
+        {
+            s->collision_rect = bitmap_cell_rectangle(s->collision_bitmap, s->position);
+        }
+        else
+        {
+            int cw = bitmap_cell_width(s->collision_bitmap);
+            int ch = bitmap_cell_height(s->collision_bitmap);
+
+            point_2d pts[4];
+            pts[0] = point_at(0, 0);
+            pts[1] = point_at(0, ch - 1);
+            pts[2] = point_at(cw - 1, 0);
+            pts[3] = point_at(cw - 1, ch - 1);
+
+            for (int i = 0; i < 4; i++)
+            {
+                pts[i] = matrix_multiply(s->location_matrix, pts[i]);
+            }
+
+            float min_x = pts[0].x;
+            float max_x = pts[0].x;
+            float min_y = pts[0].y;
+            float max_y = pts[0].y;
+
+            for (int i = 1; i < 4; i++)
+            {
+                if ( pts[i].x < min_x ) min_x = pts[i].x;
+                else if ( pts[i].x > max_x ) max_x = pts[i].x;
+
+                if ( pts[i].y < min_y ) min_y = pts[i].y;
+                else if ( pts[i].y > max_y ) max_y = pts[i].y;
+            }
+
+            s->collision_rect = rectangle_from(min_x, min_y, max_x - min_x, max_y - min_y);
+        }
+
+        s->transform_valid = true;
+    }
+
     //-----------------------------------------------------------------------------
     // Event Utility Code
     //-----------------------------------------------------------------------------
 
+    // An event or animation sound raised while updating a sprite on a worker
+    // thread. These are held, in the order they were raised, until the update
+    // is complete, and then dispatched on the thread that called
+    // update_all_sprites_in_parallel. Entries with a sound play it, the others
+    // raise their event.
+    struct _deferred_sprite_update
+    {
+        sprite              target;
+        sprite_event_kind   event;
+        sound_effect        sound;
+    };
+
+    static thread_local vector<_deferred_sprite_update> *_deferred_updates = nullptr;
+
+    // Sprites freed by event handlers while buffered events are dispatched.
+    // Their remaining events and sounds are skipped, as a new sprite may
+    // already be using the freed handle.
+    static vector<sprite> *_freed_during_dispatch = nullptr;
+
     //
     // loop through all event listeners and notif(y them of the event )
     //
@@ -105,6 +388,13 @@ namespace splashkit_lib
             LOG(WARNING) << "Attempting to use invalid sprite";
             return;
         }
+
+        if ( _deferred_updates )
+        {
+            _deferred_updates->push_back({ s, evt, nullptr });
+            return;
+        }
+
         int i;
 
         // this sprite"s event handlers
@@ -179,7 +469,7 @@ namespace splashkit_lib
         }
 
         //allocate the space for the sprite
-        sprite result = new _sprite_data();
+        sprite result = _sprite_pool.allocate();
 
         result->id = SPRITE_PTR;
         result->name = sn;
@@ -197,9 +487,9 @@ namespace splashkit_lib
         result->visible_layers.push_back(0);                //The first layer (at idx 0) is drawn
 
         // Setup the values
-        result->values[MASS_KEY] = 1;
-        result->values[ROTATION_KEY] = 0;
-        result->values[SCALE_KEY] = 1;
+        result->mass = 1;
+        result->rotation = 0;
+        result->scale = 1;
 
         // Position the sprite
         result->position = point_at(0,0);
@@ -222,6 +512,11 @@ namespace splashkit_lib
         result->moving_vec = vector_to(0,0);
         result->arrive_in_sec = 0;
 
+        // Broad-phase details, placed in the grid on the next pack query
+        result->in_grid = false;
+        result->grid_dirty = false;
+        _sprite_transform_changed(result);
+
         if ( _sprite_timer == nullptr )
         {
             _sprite_timer = create_timer("*SK* SpriteTimer");
@@ -278,12 +573,16 @@ namespace splashkit_lib
             LOG(WARNING) << "Error removing sprite from sprite pack!";
         }
 
+        _grid_remove(s);
+        if ( s->grid_dirty ) erase_from_vector(s->grid.dirty, s);
+
         // Remove from hashtable
         // Write_ln("Freeing sprite named: ", s->name);
         _sprites.erase(s->name);
 
-        s->id = NONE_PTR;
-        delete s;
+        if ( _freed_during_dispatch ) _freed_during_dispatch->push_back(s);
+
+        _sprite_pool.release(s);
     }
 
     void free_all_sprites()
@@ -291,6 +590,11 @@ namespace splashkit_lib
         FREE_ALL_FROM_MAP(_sprites, SPRITE_PTR, free_sprite);
     }
 
+    pool_statistics sprite_pool_statistics()
+    {
+        return _sprite_pool.statistics();
+    }
+
     //-----------------------------------------------------------------------------
     // Sprite fetching functions
     //-----------------------------------------------------------------------------
@@ -330,6 +634,7 @@ namespace splashkit_lib
         int result = static_cast<int>(s->layers.size() - 1);
         s->layer_names[layer_names] = result;
         s->layer_offsets.push_back(vector_to(0,0));
+        _sprite_layers_changed(s);
 
         return result;
     }
@@ -426,6 +731,7 @@ namespace splashkit_lib
 
         //Extend layers and add index
         s->visible_layers.push_back(id);
+        _sprite_layers_changed(s);
 
         return static_cast<int>(s->visible_layers.size() - 1);
     }
@@ -444,6 +750,7 @@ namespace splashkit_lib
             return;
 
         erase_from_vector(s->visible_layers, id);
+        _sprite_layers_changed(s);
     }
 
     void sprite_toggle_layer_visible(sprite s, const string &name)
@@ -525,6 +832,7 @@ namespace splashkit_lib
         if ( not sprite_has_layer(s, idx) )
             return;
         s->layer_offsets[idx] = value;
+        _sprite_layers_changed(s);
     }
 
     int sprite_visible_index_of_layer(sprite s, const string &name)
@@ -611,7 +919,7 @@ namespace splashkit_lib
         if ( not sprite_has_layer(s, idx) )
             return circle_at(0, 0, 0);
         else
-            return bitmap_cell_circle(s->layers[idx], center_point(s), sprite_scale(s));
+            return bitmap_cell_circle(s->layers[idx], center_point(s), s->scale);
     }
 
     int sprite_layer_height(sprite s, const string &name)
@@ -831,19 +1139,36 @@ namespace splashkit_lib
         update_sprite(s, pct, true);
     }
 
-    void update_sprite(sprite s, float pct, bool with_sound)
+    //
+    // Update the sprite, with the mouse details read up front so that this
+    // can be called from worker threads.
+    //
+    static void _update_sprite(sprite s, float pct, bool with_sound, bool clicked, const point_2d &mouse)
     {
         if ( VALID_PTR(s, SPRITE_PTR) )
         {
             move_sprite(s, pct);
-            update_sprite_animation(s, pct, with_sound);
+
+            if ( _deferred_updates )
+            {
+                // Sound effects are played after the update, along with the events
+                update_sprite_animation(s, pct, false);
+
+                animation anim = s->animation_info;
+                if ( with_sound and VALID_PTR(anim, ANIMATION_PTR) and anim->entered_frame and ASSIGNED(anim->current_frame) and ASSIGNED(anim->current_frame->sound) )
+                    _deferred_updates->push_back({ s, SPRITE_ARRIVED_EVENT, anim->current_frame->sound });
+            }
+            else
+            {
+                update_sprite_animation(s, pct, with_sound);
+            }
 
             //   if mouse_clicked(LEFT_BUTTON) and circle_circle_collision(sprite_collision_circle(s), circle_at(mouse_x(), mouse_y(), 17))
             //   {
             //     sprite_raise_event(s, sprite_touched_event);
             //   }
 
-            if ( mouse_clicked(LEFT_BUTTON) and circles_intersect(sprite_collision_circle(s), circle_at(mouse_x(), mouse_y(), 1)))
+            if ( clicked and circles_intersect(sprite_collision_circle(s), circle_at(mouse.x, mouse.y, 1)))
             {
                 sprite_raise_event(s, SPRITE_CLICKED_EVENT);
             }
@@ -856,10 +1181,106 @@ namespace splashkit_lib
         }
     }
 
+    void update_sprite(sprite s, float pct, bool with_sound)
+    {
+        _update_sprite(s, pct, with_sound, mouse_clicked(LEFT_BUTTON), mouse_position());
+    }
+
     //-----------------------------------------------------------------------------
     // Sprite drawing
     //-----------------------------------------------------------------------------
 
+    static int _sprites_drawn = 0;
+    static int _sprites_culled = 0;
+
+    //
+    // Calculate the area the sprite's visible layers cover when drawn. Each
+    // layer is scaled around its center, and rotated around the anchor
+    // point -- so a rotated layer is kept within a circle around the anchor.
+    //
+    static void _update_draw_bounds(sprite s)
+    {
+        bool animated = VALID_PTR(s->animation_info, ANIMATION_PTR);
+        double scale = fabs(s->scale);
+        double anchor_x = s->anchor_point.x - sprite_layer_width(s, 0) / 2.0;
+        double anchor_y = s->anchor_point.y - sprite_layer_height(s, 0) / 2.0;
+        double left = 0, top = 0, right = 0, bottom = 0;
+
+        for (size_t i = 0; i < s->visible_layers.size(); i++)
+        {
+            int idx = s->visible_layers[i];
+            bitmap layer = s->layers[idx];
+            double w = animated ? bitmap_cell_width(layer) : bitmap_width(layer);
+            double h = animated ? bitmap_cell_height(layer) : bitmap_height(layer);
+
+            double cx = s->position.x + s->layer_offsets[idx].x + w / 2.0;
+            double cy = s->position.y + s->layer_offsets[idx].y + h / 2.0;
+            if ( s->draw_at_anchor_point )
+            {
+                cx -= s->anchor_point.x;
+                cy -= s->anchor_point.y;
+            }
+
+            double half_w, half_h;
+            if ( s->rotation == 0 )
+            {
+                half_w = w * scale / 2.0;
+                half_h = h * scale / 2.0;
+            }
+            else
+            {
+                cx += anchor_x * scale;
+                cy += anchor_y * scale;
+                half_w = half_h = scale * (sqrt(anchor_x * anchor_x + anchor_y * anchor_y) + sqrt(w * w + h * h) / 2.0);
+            }
+
+            if ( i == 0 or cx - half_w < left ) left = cx - half_w;
+            if ( i == 0 or cy - half_h < top ) top = cy - half_h;
+            if ( i == 0 or cx + half_w > right ) right = cx + half_w;
+            if ( i == 0 or cy + half_h > bottom ) bottom = cy + half_h;
+        }
+
+        // Allow for drawing rounding to whole pixels
+        s->draw_bounds = rectangle_from(left - 1, top - 1, right - left + 2, bottom - top + 2);
+        s->draw_bounds_animated = animated;
+        s->draw_bounds_valid = true;
+    }
+
+    //
+    // Is the sprite entirely outside the camera's view of the current window?
+    //
+    static bool _sprite_culled(sprite s, double x_offset, double y_offset)
+    {
+        window wind = current_window();
+        if ( INVALID_PTR(wind, WINDOW_PTR) or s->visible_layers.empty() ) return false;
+
+        _check_sprite_cell_details(s);
+        if ( not s->draw_bounds_valid or s->draw_bounds_animated != VALID_PTR(s->animation_info, ANIMATION_PTR) )
+            _update_draw_bounds(s);
+
+        rectangle area = s->draw_bounds;
+        area.x += x_offset;
+        area.y += y_offset;
+
+        return not rectangles_intersect(area, rectangle_from(camera_x(), camera_y(), window_width(wind), window_height(wind)));
+    }
+
+    int sprites_drawn_count()
+    {
+        return _sprites_drawn;
+    }
+
+    int sprites_culled_count()
+    {
+        return _sprites_culled;
+    }
+
+    void reset_sprite_draw_counts()
+    {
+        _sprites_drawn = 0;
+        _sprites_culled = 0;
+    }
+
     void draw_sprite(sprite s)
     {
         draw_sprite(s, 0, 0);
@@ -870,15 +1291,20 @@ namespace splashkit_lib
         draw_sprite(s, offset.x, offset.y);
     }
 
-    void draw_sprite(sprite s, double x_offset, double y_offset)
+    //
+    // Draw the visible layers of the sprite, or add them to the render queue
+    // in the indicated layer when queued is true.
+    //
+    static void _draw_sprite_layers(sprite s, double x_offset, double y_offset, bool queued, int layer)
     {
-        if ( INVALID_PTR(s, SPRITE_PTR) )
+        if ( _sprite_culled(s, x_offset, y_offset) )
         {
-            LOG(WARNING) << "Attempting to use invalid sprite";
+            _sprites_culled++;
             return;
         }
+        _sprites_drawn++;
 
-        float angle = sprite_rotation(s);
+        float angle = s->rotation;
         drawing_options opts;
 
         if (angle != 0)
@@ -888,28 +1314,60 @@ namespace splashkit_lib
         else
             opts = option_defaults();
 
-        float scale = sprite_scale(s);
+        float scale = s->scale;
         if (scale != 1)
             opts = option_scale_bmp( scale, scale, opts );
 
         opts = option_with_animation( s->animation_info, opts );
 
         int idx;
+        double x, y;
         for (int i = 0; i < s->visible_layers.size(); i++)
         {
             idx = s->visible_layers[i];
+            x = s->position.x + x_offset + s->layer_offsets[idx].x;
+            y = s->position.y + y_offset + s->layer_offsets[idx].y;
+
             if ( s->draw_at_anchor_point )
-                draw_bitmap(
-                            sprite_layer(s, idx),
-                            s->position.x - s->anchor_point.x + x_offset + s->layer_offsets[idx].x,
-                            s->position.y -s->anchor_point.y + y_offset + s->layer_offsets[idx].y,
-                            opts);
+            {
+                x -= s->anchor_point.x;
+                y -= s->anchor_point.y;
+            }
+
+            if ( queued )
+                _queue_bitmap(sprite_layer(s, idx), x, y, layer, i, opts);
             else
-                draw_bitmap(
-                            sprite_layer(s, idx),
-                            s->position.x + x_offset + s->layer_offsets[idx].x,
-                            s->position.y + y_offset + s->layer_offsets[idx].y,
-                            opts);
+                draw_bitmap(sprite_layer(s, idx), x, y, opts);
+        }
+    }
+
+    void draw_sprite(sprite s, double x_offset, double y_offset)
+    {
+        if ( INVALID_PTR(s, SPRITE_PTR) )
+        {
+            LOG(WARNING) << "Attempting to use invalid sprite";
+            return;
+        }
+
+        _draw_sprite_layers(s, x_offset, y_offset, false, 0);
+    }
+
+    void queue_sprite(sprite s, int layer)
+    {
+        if ( INVALID_PTR(s, SPRITE_PTR) )
+        {
+            LOG(WARNING) << "Attempting to queue invalid sprite";
+            return;
+        }
+
+        _draw_sprite_layers(s, 0, 0, true, layer);
+    }
+
+    void queue_all_sprites(int layer)
+    {
+        for (void *s : current_pack())
+        {
+            queue_sprite(static_cast<sprite>(s), layer);
         }
     }
 
@@ -939,6 +1397,7 @@ namespace splashkit_lib
         if ( VALID_PTR(s, SPRITE_PTR) )
         {
             s->anchor_point = pt;
+            _sprite_transform_changed(s);
         }
         else
         {
@@ -973,7 +1432,7 @@ namespace splashkit_lib
         }
 
         vector_2d mvmt;
-        float angle = sprite_rotation(s);
+        float angle = s->rotation;
 
         if (angle != 0)
         {
@@ -987,6 +1446,7 @@ namespace splashkit_lib
 
         s->position.x += pct * mvmt.x;
         s->position.y += pct * mvmt.y;
+        _sprite_transform_changed(s);
 
         if ( s->is_moving )
         {
@@ -1026,6 +1486,8 @@ namespace splashkit_lib
             s->position.x += s->anchor_point.x;
             s->position.y += s->anchor_point.y;
         }
+
+        _sprite_transform_changed(s);
     }
 
     void move_sprite(sprite s)
@@ -1081,6 +1543,7 @@ namespace splashkit_lib
         }
 
         s->position.x = value;
+        _sprite_transform_changed(s);
     }
 
     float sprite_x(sprite s)
@@ -1103,6 +1566,7 @@ namespace splashkit_lib
         }
 
         s->position.y = value;
+        _sprite_transform_changed(s);
     }
 
     float sprite_y(sprite s)
@@ -1134,6 +1598,7 @@ namespace splashkit_lib
         if ( VALID_PTR(s, SPRITE_PTR) )
         {
             s->position = value;
+            _sprite_transform_changed(s);
         }
         else
         {
@@ -1246,6 +1711,7 @@ namespace splashkit_lib
     {
         if ( INVALID_PTR(s, SPRITE_PTR) ) return;
         s->draw_at_anchor_point = value;
+        _sprite_layers_changed(s);
     }
 
     void sprite_move_to(sprite s, const point_2d &pt, float taking_seconds)
@@ -1265,29 +1731,30 @@ namespace splashkit_lib
 
     matrix_2d sprite_location_matrix(sprite s)
     {
-        matrix_2d result = identity_matrix();
-
         if ( INVALID_PTR(s, SPRITE_PTR) )
         {
             LOG(WARNING) << "Attempting to use invalid sprite";
-            return result;
+            return identity_matrix();
         }
 
-        float scale = sprite_scale(s);
-        float w = sprite_layer_width(s, 0);
-        float h = sprite_layer_height(s, 0);
+        _check_sprite_cell_details(s);
+        if ( not s->transform_valid ) _update_sprite_transform(s);
 
-        matrix_2d anchor_matrix = translation_matrix(sprite_anchor_point(s));
+        return s->location_matrix;
+    }
 
-        result = matrix_multiply(result, matrix_inverse(anchor_matrix));
-        result = matrix_multiply(result, rotation_matrix(sprite_rotation(s)));
-        result = matrix_multiply(result, anchor_matrix);
+    matrix_2d sprite_location_matrix_inverse(sprite s)
+    {
+        if ( INVALID_PTR(s, SPRITE_PTR) )
+        {
+            LOG(WARNING) << "Attempting to use invalid sprite";
+            return identity_matrix();
+        }
 
-        float new_x = sprite_x(s) - (w * scale / 2.0) + (w / 2.0);
-        float new_y = sprite_y(s) - (h * scale / 2.0) + (h / 2.0);
-        result = matrix_multiply(result, translation_matrix(new_x / scale, new_y / scale));
+        _check_sprite_cell_details(s);
+        if ( not s->transform_valid ) _update_sprite_transform(s);
 
-        return matrix_multiply(result, scale_matrix(scale));
+        return s->location_inverse;
     }
 
     //---------------------------------------------------------------------------
@@ -1303,7 +1770,7 @@ namespace splashkit_lib
         }
         else
         {
-            return s->values[MASS_KEY];
+            return s->mass;
         }
 
     }
@@ -1311,7 +1778,7 @@ namespace splashkit_lib
     void sprite_set_mass(sprite s, float value)
     {
         if ( VALID_PTR(s, SPRITE_PTR) )
-            s->values[MASS_KEY] = value;
+            s->mass = value;
     }
 
     float sprite_rotation(sprite s)
@@ -1323,7 +1790,7 @@ namespace splashkit_lib
         }
         else
         {
-            return s->values[ROTATION_KEY];
+            return s->rotation;
         }
 
     }
@@ -1342,7 +1809,8 @@ namespace splashkit_lib
                 value = value - trunc(value / 360) * 360;
             }
 
-            s->values[ROTATION_KEY] = value;
+            s->rotation = value;
+            _sprite_transform_changed(s);
         }
         else
         {
@@ -1355,14 +1823,15 @@ namespace splashkit_lib
         if ( INVALID_PTR(s, SPRITE_PTR) )
             return 0;
         else
-            return s->values[SCALE_KEY];
+            return s->scale;
     }
 
     void sprite_set_scale(sprite s, float value)
     {
         if ( VALID_PTR(s, SPRITE_PTR) )
         {
-            s->values[SCALE_KEY] = value;
+            s->scale = value;
+            _sprite_transform_changed(s);
         }
     }
 
@@ -1374,7 +1843,7 @@ namespace splashkit_lib
             return -1;
         }
 
-        return static_cast<int>(s->values.size());
+        return static_cast<int>(s->values.size()) + BUILTIN_VALUE_COUNT;
     }
 
     bool sprite_has_value(sprite s, string name)
@@ -1385,6 +1854,8 @@ namespace splashkit_lib
             return false;
         }
 
+        if ( name == MASS_KEY or name == ROTATION_KEY or name == SCALE_KEY ) return true;
+
         return s->values.count(name) > 0;
     }
 
@@ -1394,6 +1865,11 @@ namespace splashkit_lib
         {
             return 0;
         }
+
+        if ( name == MASS_KEY ) return s->mass;
+        if ( name == ROTATION_KEY ) return s->rotation;
+        if ( name == SCALE_KEY ) return s->scale;
+
         return s->values[name];
     }
 
@@ -1423,7 +1899,10 @@ namespace splashkit_lib
             return;
         }
 
-        s->values[name] = val;
+        if ( name == MASS_KEY ) sprite_set_mass(s, val);
+        else if ( name == ROTATION_KEY ) sprite_set_rotation(s, val);
+        else if ( name == SCALE_KEY ) sprite_set_scale(s, val);
+        else s->values[name] = val;
     }
 
     //---------------------------------------------------------------------------
@@ -1520,6 +1999,75 @@ namespace splashkit_lib
         update_all_sprites(1.0);
     }
 
+    // Sprites are updated in parallel in chunks of this many sprites
+#define PARALLEL_UPDATE_CHUNK 512
+
+    void update_all_sprites_in_parallel()
+    {
+        update_all_sprites_in_parallel(1.0);
+    }
+
+    void update_all_sprites_in_parallel(float pct)
+    {
+        // use a local copy so changes to the sprite pack do not effect loop
+        vector<void *> local_copy = current_pack();
+        size_t chunks = (local_copy.size() + PARALLEL_UPDATE_CHUNK - 1) / PARALLEL_UPDATE_CHUNK;
+
+        if ( chunks < 2 )
+        {
+            _call_for_all_sprites(local_copy, &_update_sprite_pct, pct);
+            return;
+        }
+
+        bool clicked = mouse_clicked(LEFT_BUTTON);
+        point_2d mouse = mouse_position();
+
+        // Place every sprite in its grid's moved list now, so workers do not
+        // need to change the shared list as they move the sprites.
+        for (void *s : local_copy)
+        {
+            _grid_mark_moved(static_cast<sprite>(s));
+        }
+
+        vector<vector<_deferred_sprite_update>> buffers(chunks);
+
+        shared_worker_pool().run_all(chunks, [&](size_t chunk)
+        {
+            _deferred_updates = &buffers[chunk];
+
+            size_t end = std::min((chunk + 1) * PARALLEL_UPDATE_CHUNK, local_copy.size());
+            for (size_t i = chunk * PARALLEL_UPDATE_CHUNK; i < end; i++)
+            {
+                _update_sprite(static_cast<sprite>(local_copy[i]), pct, true, clicked, mouse);
+            }
+
+            _deferred_updates = nullptr;
+        });
+
+        // Chunks are in pack order, and each holds its sprites' sounds and
+        // events in the order they were raised, so replaying them in turn
+        // matches update_all_sprites
+        vector<sprite> freed;
+        vector<sprite> *outer_freed = _freed_during_dispatch;
+        _freed_during_dispatch = &freed;
+
+        for (vector<_deferred_sprite_update> &buffer : buffers)
+        {
+            for (const _deferred_sprite_update &update : buffer)
+            {
+                if ( std::find(freed.begin(), freed.end(), update.target) != freed.end() ) continue;
+
+                if ( update.sound )
+                    play_sound_effect(update.sound);
+                else
+                    sprite_raise_event(update.target, update.event);
+            }
+        }
+
+        _freed_during_dispatch = outer_freed;
+        if ( outer_freed ) outer_freed->insert(outer_freed->end(), freed.begin(), freed.end());
+    }
+
     bool has_sprite_pack(const string &name)
     {
         return _sprite_packs.count(name) > 0;
@@ -1560,6 +2108,125 @@ namespace splashkit_lib
         _call_for_all_sprites(pack, &_free_sprite);
 
         _sprite_packs.erase(name);
+        _pack_grids.erase(name);
+    }
+
+    vector<sprite_pair> sprite_pack_collisions()
+    {
+        return sprite_pack_collisions(_current_pack);
+    }
+
+    vector<sprite_pair> sprite_pack_collisions(const string &name)
+    {
+        vector<sprite_pair> result;
+
+        if ( not has_sprite_pack(name) )
+        {
+            LOG(WARNING) << "No sprite_pack named " + name + " to check for collisions.";
+            return result;
+        }
+
+        vector<void *> &pack = _sprite_packs[name];
+        _sprite_grid &grid = _pack_grids[name];
+        _refresh_grid(grid);
+
+        unordered_map<sprite, size_t> order;
+        for (size_t i = 0; i < pack.size(); i++)
+            order[static_cast<sprite>(pack[i])] = i;
+
+        for (auto &cell : grid.cells)
+        {
+            int col = static_cast<int>(cell.first >> 32);
+            int row = static_cast<int>(static_cast<uint32_t>(cell.first));
+            const vector<sprite> &sprites = cell.second;
+
+            for (size_t i = 0; i < sprites.size(); i++)
+            {
+                sprite s1 = sprites[i];
+
+                for (size_t j = i + 1; j < sprites.size(); j++)
+                {
+                    sprite s2 = sprites[j];
+
+                    // Sprites spanning several cells share more than one. Only
+                    // test the pair in the top left cell they have in common.
+                    if ( std::max(s1->grid_left, s2->grid_left) != col or std::max(s1->grid_top, s2->grid_top) != row )
+                        continue;
+
+                    if ( not rectangles_intersect(s1->grid_bounds, s2->grid_bounds) )
+                        continue;
+
+                    if ( sprite_collision(s1, s2) )
+                    {
+                        if ( order[s1] < order[s2] )
+                            result.push_back({s1, s2});
+                        else
+                            result.push_back({s2, s1});
+                    }
+                }
+            }
+        }
+
+        std::sort(result.begin(), result.end(), [&order](const sprite_pair &a, const sprite_pair &b)
+        {
+            if ( order[a.first] != order[b.first] ) return order[a.first] < order[b.first];
+            return order[a.second] < order[b.second];
+        });
+
+        return result;
+    }
+
+    vector<sprite> sprites_in_rectangle(const rectangle &rect)
+    {
+        vector<sprite> result;
+        _sprite_grid &grid = current_pack_grid();
+        _refresh_grid(grid);
+
+        int left = _grid_cell(rect.x);
+        int top = _grid_cell(rect.y);
+        int right = _grid_cell(rect.x + rect.width);
+        int bottom = _grid_cell(rect.y + rect.height);
+
+        for (int col = left; col <= right; col++)
+        {
+            for (int row = top; row <= bottom; row++)
+            {
+                auto it = grid.cells.find(_grid_key(col, row));
+                if ( it == grid.cells.end() ) continue;
+
+                for (sprite s : it->second)
+                {
+                    // Report sprites once, from the first cell they share with the rectangle
+                    if ( std::max(s->grid_left, left) != col or std::max(s->grid_top, top) != row )
+                        continue;
+
+                    if ( rectangles_intersect(s->grid_bounds, rect) and sprite_rectangle_collision(s, rect) )
+                        result.push_back(s);
+                }
+            }
+        }
+
+        _sort_by_pack_order(current_pack(), result);
+        return result;
+    }
+
+    vector<sprite> sprites_at(const point_2d &pt)
+    {
+        vector<sprite> result;
+        _sprite_grid &grid = current_pack_grid();
+        _refresh_grid(grid);
+
+        auto it = grid.cells.find(_grid_key(_grid_cell(pt.x), _grid_cell(pt.y)));
+        if ( it == grid.cells.end() ) return result;
+
+        for (sprite s : it->second)
+        {
+            if ( point_in_rectangle(pt, s->grid_bounds) and sprite_point_collision(s, pt) )
+                result.push_back(s);
+        }
+
+        _sort_by_pack_order(current_pack(), result);
+        return result;
     }
 
     void free_all_sprite_packs()
@@ -1607,42 +2274,11 @@ namespace splashkit_lib
     {
         if ( INVALID_PTR(s, SPRITE_PTR) )
             return rectangle_from(0,0,0,0);
-        else if (sprite_rotation(s) == 0 and sprite_scale(s) == 1)
-            return bitmap_cell_rectangle(s->collision_bitmap, s->position);
-        else
-        {
-            int cw = bitmap_cell_width(s->collision_bitmap);
-            int ch = bitmap_cell_height(s->collision_bitmap);
-
-            point_2d pts[4];
-            pts[0] = point_at(0, 0);
-            pts[1] = point_at(0, ch - 1);
-            pts[2] = point_at(cw - 1, 0);
-            pts[3] = point_at(cw - 1, ch - 1);
 
-            matrix_2d m = sprite_location_matrix(s);
+        _check_sprite_cell_details(s);
+        if ( not s->transform_valid ) _update_sprite_transform(s);
 
-            for (int i = 0; i < 4; i++)
-            {
-                pts[i] = matrix_multiply(m, pts[i]);
-            }
-
-            float min_x = pts[0].x;
-            float max_x = pts[0].x;
-            float min_y = pts[0].y;
-            float max_y = pts[0].y;
-
-            for (int i = 1; i < 4; i++)
-            {
-                if ( pts[i].x < min_x ) min_x = pts[i].x;
-                else if ( pts[i].x > max_x ) max_x = pts[i].x;
-
-                if ( pts[i].y < min_y ) min_y = pts[i].y;
-                else if ( pts[i].y > max_y ) max_y = pts[i].y;
-            }
-
-            return rectangle_from(min_x, min_y, max_x - min_x, max_y - min_y);
-        }
+        return s->collision_rect;
     }
 
     circle sprite_collision_circle(sprite s)
@@ -1650,7 +2286,7 @@ namespace splashkit_lib
         if ( INVALID_PTR(s, SPRITE_PTR) or INVALID_PTR(s->collision_bitmap, BITMAP_PTR) )
             return circle_at(0, 0, 0);
         else
-            return bitmap_cell_circle(s->collision_bitmap, center_point(s), sprite_scale(s));
+            return bitmap_cell_circle(s->collision_bitmap, center_point(s), s->scale);
     }
 
     collision_test_kind sprite_collision_kind(sprite s)
@@ -1676,6 +2312,10 @@ namespace splashkit_lib
 
     void sprite_set_collision_bitmap(sprite s, bitmap bmp)
     {
-        if ( VALID_PTR(s, SPRITE_PTR) ) s->collision_bitmap = bmp;
+        if ( VALID_PTR(s, SPRITE_PTR) )
+        {
+            s->collision_bitmap = bmp;
+            _sprite_transform_changed(s);
+        }
     }
 }
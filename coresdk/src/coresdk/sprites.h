@@ -61,6 +61,19 @@ namespace splashkit_lib
      */
     typedef struct _sprite_data *sprite;
 
+    /**
+     * A sprite_pair records two sprites from a sprite pack that are
+     * colliding. These are returned from `sprite_pack_collisions`.
+     *
+     * @field first   The sprite that appears first in the sprite pack.
+     * @field second  The sprite it is colliding with.
+     */
+    struct sprite_pair
+    {
+        sprite first;
+        sprite second;
+    };
+
     /**
      *  The sprite_event_handler function pointer is used when you want to register
      *  to receive events from a Sprite.
@@ -238,6 +251,15 @@ namespace splashkit_lib
      */
     void free_all_sprites();
 
+    /**
+     * Returns statistics on the pooled storage used for sprites. Freed
+     * sprites return their storage to the pool, where it is reused by the
+     * next sprite created.
+     *
+     * @returns The current sprite pool statistics.
+     */
+    pool_statistics sprite_pool_statistics();
+
     //---------------------------------------------------------------------------
     // Event Code
     //---------------------------------------------------------------------------
@@ -695,6 +717,20 @@ namespace splashkit_lib
      */
     matrix_2d sprite_location_matrix(sprite s);
 
+    /**
+     * Returns the inverse of the sprite's location matrix. This can be used
+     * to transform points in the game into the sprite's bitmap, for example
+     * to find the pixel of the sprite at the mouse position.
+     *
+     * @param s     The sprite to get the details from.
+     * @returns     A matrix that transforms points from the game into the
+     *              sprite's coordinate space.
+     *
+     * @attribute class sprite
+     * @attribute getter location_matrix_inverse
+     */
+    matrix_2d sprite_location_matrix_inverse(sprite s);
+
     //---------------------------------------------------------------------------
     // sprite animation code
     //---------------------------------------------------------------------------
@@ -965,7 +1001,8 @@ namespace splashkit_lib
 
     /**
      * Draws the sprite at its location in the world. This is affected by the
-     * position of the camera and the sprites current location.
+     * position of the camera and the sprites current location. Sprites that
+     * are entirely outside the camera's view are not drawn.
      *
      * This is the standard routine for drawing sprites to the screen and should be
      * used in most cases.
@@ -1008,6 +1045,55 @@ namespace splashkit_lib
      */
     void draw_sprite(sprite s, const vector_2d &offset);
 
+    /**
+     * Returns the number of sprites drawn since the counts were last reset.
+     * Sprites that are entirely outside the camera's view are skipped by
+     * `draw_sprite` and `draw_all_sprites`, and are not counted here.
+     *
+     * @returns The number of sprites drawn.
+     */
+    int sprites_drawn_count();
+
+    /**
+     * Returns the number of sprites skipped since the counts were last reset,
+     * as they were entirely outside the camera's view of the current window.
+     *
+     * @returns The number of sprites that were not drawn.
+     */
+    int sprites_culled_count();
+
+    /**
+     * Sets the counts of drawn and culled sprites back to zero. Call this
+     * each frame to see how many sprites are skipped in that frame.
+     */
+    void reset_sprite_draw_counts();
+
+    /**
+     * Adds the sprite to the render queue in the indicated layer, to be drawn
+     * when `draw_render_queue` is called. Like `draw_sprite`, sprites outside
+     * the camera's view are skipped. Each visible layer of the sprite is
+     * queued in the same render layer, so sprites sharing a bitmap can be
+     * drawn in one batch. The sprite's own layers are still drawn in order,
+     * but use different render layers for sprites whose drawing order
+     * matters.
+     *
+     * @param s     The sprite to queue.
+     * @param layer The render layer to draw the sprite in, higher layers are
+     *              drawn on top of lower layers.
+     *
+     * @attribute class sprite
+     * @attribute method queue
+     */
+    void queue_sprite(sprite s, int layer);
+
+    /**
+     * Adds all of the sprites in the current sprite pack to the render queue
+     * in the indicated layer.
+     *
+     * @param layer The render layer to draw the sprites in.
+     */
+    void queue_all_sprites(int layer);
+
     //---------------------------------------------------------------------------
     // movement code
     //---------------------------------------------------------------------------
@@ -1812,6 +1898,30 @@ namespace splashkit_lib
      */
     void update_all_sprites(float pct);
 
+    /**
+     * Update all of the sprites in the current sprite pack, spreading the
+     * work over several threads. Sprite events and animation sounds are
+     * held until all of the sprites have been updated, and are then raised
+     * on the calling thread, sprite by sprite, in the order that
+     * `update_all_sprites` would raise them. Event
+     * handlers can therefore safely change sprites and sprite packs.
+     *
+     * This is useful for packs with many thousands of sprites. Smaller packs
+     * are updated on the calling thread.
+     */
+    void update_all_sprites_in_parallel();
+
+    /**
+     * Update all of the sprites in the current sprite pack using several
+     * threads, passing in a percentage value to indicate the percentage to
+     * update.
+     *
+     * @param pct The percentage of the update to apply.
+     *
+     * @attribute suffix  percent
+     */
+    void update_all_sprites_in_parallel(float pct);
+
     /**
      * Call the supplied function for all sprites in the current pack.
      *
@@ -1868,5 +1978,50 @@ namespace splashkit_lib
      * @returns The name of the current sprite pack.
      */
     string current_sprite_pack();
+
+    /**
+     * Returns all of the pairs of colliding sprites in the current sprite
+     * pack. Each sprite pack keeps its sprites in a grid that is updated as
+     * they move, so only sprites that are near each other are tested with
+     * `sprite_collision`. This is much faster than testing each pair of
+     * sprites yourself when there are many sprites in the pack.
+     *
+     * @returns The colliding pairs, in the order the sprites were added to
+     *          the pack.
+     */
+    vector<sprite_pair> sprite_pack_collisions();
+
+    /**
+     * Returns all of the pairs of colliding sprites in the named sprite pack.
+     *
+     * @param name  The name of the sprite pack to check.
+     * @returns     The colliding pairs, in the order the sprites were added
+     *              to the pack.
+     *
+     * @attribute suffix  in_pack
+     */
+    vector<sprite_pair> sprite_pack_collisions(const string &name);
+
+    /**
+     * Returns the sprites in the current sprite pack that are drawn within
+     * the indicated area. Only sprites near the rectangle are tested with
+     * `sprite_rectangle_collision`.
+     *
+     * @param rect  The area to search.
+     * @returns     The sprites in the area, in the order they were added to
+     *              the pack.
+     */
+    vector<sprite> sprites_in_rectangle(const rectangle &rect);
+
+    /**
+     * Returns the sprites in the current sprite pack that are drawn at the
+     * indicated point. Only sprites near the point are tested with
+     * `sprite_point_collision`.
+     *
+     * @param pt  The point to search.
+     * @returns   The sprites at the point, in the order they were added to
+     *            the pack.
+     */
+    vector<sprite> sprites_at(const point_2d &pt);
 }
 #endif /* sprites_h */
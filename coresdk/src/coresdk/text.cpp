@@ -342,4 +342,45 @@ namespace splashkit_lib
     {
         return text_height(text, font_named(fnt), font_size);
     }
+
+    void set_text_caching(bool caching)
+    {
+        sk_set_text_cache(caching);
+    }
+
+    bool text_caching()
+    {
+        return sk_text_cache_enabled();
+    }
+
+    void set_text_cache_budget(int bytes)
+    {
+        if ( bytes < 0 )
+        {
+            LOG(WARNING) << "Text cache budget must not be negative";
+            return;
+        }
+
+        sk_set_text_cache_budget(static_cast<size_t>(bytes));
+    }
+
+    int text_cache_budget()
+    {
+        return static_cast<int>(sk_text_cache_budget());
+    }
+
+    void clear_text_cache()
+    {
+        sk_clear_text_cache();
+    }
+
+    text_cache_statistics current_text_cache_statistics()
+    {
+        return sk_text_cache_statistics();
+    }
+
+    void reset_text_cache_statistics()
+    {
+        sk_reset_text_cache_statistics();
+    }
 }
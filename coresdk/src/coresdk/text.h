@@ -525,6 +525,61 @@ namespace splashkit_lib
      * @returns Returns the height of the text as an integer.
      */
     int text_height(const string &text, const string& fnt, int font_size);
+
+    /**
+     * Turns text caching on or off. Text is normally drawn a glyph at a
+     * time, which suits text that changes every frame. When caching is on,
+     * each string is instead rendered once for its font, size, style and
+     * color, and the result is kept so that drawing the same text again is a
+     * single copy. This suits labels that rarely change.
+     *
+     * The least recently drawn text is removed from the cache when it grows
+     * beyond its budget, see `set_text_cache_budget`.
+     *
+     * @param caching Pass in `true` to draw text from the cache, or `false`
+     *                to draw it a glyph at a time.
+     */
+    void set_text_caching(bool caching);
+
+    /**
+     * Indicates if text is currently drawn from the text cache.
+     *
+     * @return true if text caching is on.
+     */
+    bool text_caching();
+
+    /**
+     * Sets the amount of memory the text cache can use. The least recently
+     * drawn text is removed when the cache is over this budget.
+     *
+     * @param bytes The size of the cache in bytes.
+     */
+    void set_text_cache_budget(int bytes);
+
+    /**
+     * Returns the amount of memory the text cache can use.
+     *
+     * @return The size of the cache in bytes.
+     */
+    int text_cache_budget();
+
+    /**
+     * Removes all of the text from the text cache.
+     */
+    void clear_text_cache();
+
+    /**
+     * Returns the hits, misses and evictions of the text cache since the
+     * statistics were last reset, along with its current size.
+     *
+     * @return The current text cache statistics.
+     */
+    text_cache_statistics current_text_cache_statistics();
+
+    /**
+     * Resets the hit, miss and eviction counts of the text cache.
+     */
+    void reset_text_cache_statistics();
 }
 
 #endif /* text_hpp */
@@ -0,0 +1,333 @@
+//
+//  text_layout.cpp
+//  splashkit
+//
+//  Copyright © 2016 Andrew Cain. All rights reserved.
+//
+
+#include "text_layout.h"
+#include "text.h"
+#include "point_geometry.h"
+
+#include "text_driver.h"
+#include "backend_types.h"
+#include "utility_functions.h"
+
+#include <vector>
+
+using std::vector;
+
+namespace splashkit_lib
+{
+    struct _text_line
+    {
+        string  text;
+        size_t  start;      // index of the line's first character in the text
+        int     width;
+    };
+
+    struct _text_layout_data
+    {
+        pointer_identifier id;
+        string  text;
+        font    fnt;
+        int     font_size;
+        int     max_width;
+
+        // The layout, worked out when needed after the above change
+        bool                valid;
+        int                 font_style;     // the style of the font when laid out
+        vector<_text_line>  lines;
+        vector<int>         positions;      // x of each character, from sk_text_positions
+        int                 width;
+        int                 line_height;
+    };
+
+    static bool _is_continuation_byte(char c)
+    {
+        return (static_cast<unsigned char>(c) & 0xc0) == 0x80;
+    }
+
+    static void _add_line(text_layout layout, size_t start, size_t end)
+    {
+        // Spaces at the end of a line take up no room
+        size_t trimmed = end;
+        while (trimmed > start and layout->text[trimmed - 1] == ' ') trimmed--;
+
+        _text_line line;
+        line.text = layout->text.substr(start, trimmed - start);
+        line.start = start;
+        line.width = layout->positions[trimmed] - layout->positions[start];
+
+        if (line.width > layout->width) layout->width = line.width;
+        layout->lines.push_back(line);
+    }
+
+    //
+    // Break the text into lines. Each character is measured once, so the
+    // cost grows with the length of the text.
+    //
+    static void _perform_layout(text_layout layout)
+    {
+        const string &text = layout->text;
+
+        layout->lines.clear();
+        layout->width = 0;
+        layout->font_style = get_font_style(layout->fnt);
+        layout->line_height = sk_text_line_skip(layout->fnt, layout->font_size);
+
+        sk_text_positions(layout->fnt, layout->font_size, text, layout->positions);
+        const vector<int> &pos = layout->positions;
+
+        size_t line_start = 0;
+        size_t last_break = 0;      // where the line can be broken, after a space
+
+        for (size_t i = 0; i < text.length(); i++)
+        {
+            if (text[i] == '\n')
+            {
+                _add_line(layout, line_start, i);
+                line_start = last_break = i + 1;
+                continue;
+            }
+
+            if (text[i] == ' ')
+            {
+                last_break = i + 1;
+                continue;
+            }
+
+            if (layout->max_width <= 0 or _is_continuation_byte(text[i])) continue;
+
+            // Does the character end beyond the width of the line?
+            size_t next = i + 1;
+            while (next < text.length() and _is_continuation_byte(text[next])) next++;
+
+            if (pos[next] - pos[line_start] <= layout->max_width) continue;
+
+            if (last_break > line_start)
+            {
+                // Wrap the current word onto the next line
+                _add_line(layout, line_start, last_break);
+                line_start = last_break;
+
+                // The word may still be too wide for a line of its own
+                if (pos[next] - pos[line_start] <= layout->max_width) continue;
+            }
+
+            if (i > line_start)
+            {
+                // The word is wider than the line, so split it here
+                _add_line(layout, line_start, i);
+                line_start = last_break = i;
+            }
+        }
+
+        _add_line(layout, line_start, text.length());
+
+        layout->valid = true;
+    }
+
+    static bool _valid_layout(text_layout layout, const string &action)
+    {
+        if (INVALID_PTR(layout, TEXT_LAYOUT_PTR))
+        {
+            LOG(WARNING) << "Attempting to " << action << " with an invalid text layout";
+            return false;
+        }
+
+        if (INVALID_PTR(layout->fnt, FONT_PTR))
+        {
+            LOG(WARNING) << "Attempting to " << action << " with a text layout whose font is invalid";
+            return false;
+        }
+
+        if (not layout->valid or layout->font_style != get_font_style(layout->fnt))
+        {
+            _perform_layout(layout);
+        }
+
+        return true;
+    }
+
+    text_layout create_text_layout(const string &text, font fnt, int font_size, int max_width)
+    {
+        if (INVALID_PTR(fnt, FONT_PTR))
+        {
+            LOG(WARNING) << "Attempting to create a text layout with an invalid font";
+            return nullptr;
+        }
+
+        text_layout result = new _text_layout_data();
+        result->id = TEXT_LAYOUT_PTR;
+        result->text = text;
+        result->fnt = fnt;
+        result->font_size = font_size;
+        result->max_width = max_width;
+        result->valid = false;
+
+        return result;
+    }
+
+    text_layout create_text_layout(const string &text, const string &fnt, int font_size, int max_width)
+    {
+        return create_text_layout(text, font_named(fnt), font_size, max_width);
+    }
+
+    void free_text_layout(text_layout layout)
+    {
+        if (INVALID_PTR(layout, TEXT_LAYOUT_PTR))
+        {
+            LOG(WARNING) << "Attempting to free an invalid text layout";
+            return;
+        }
+
+        notify_of_free(layout);
+
+        layout->id = NONE_PTR;
+        delete layout;
+    }
+
+    void text_layout_set_text(text_layout layout, const string &text)
+    {
+        if (INVALID_PTR(layout, TEXT_LAYOUT_PTR))
+        {
+            LOG(WARNING) << "Attempting to set the text of an invalid text layout";
+            return;
+        }
+
+        if (layout->text == text) return;
+
+        layout->text = text;
+        layout->valid = false;
+    }
+
+    string text_layout_text(text_layout layout)
+    {
+        if (INVALID_PTR(layout, TEXT_LAYOUT_PTR))
+        {
+            LOG(WARNING) << "Attempting to get the text of an invalid text layout";
+            return "";
+        }
+
+        return layout->text;
+    }
+
+    void text_layout_set_font(text_layout layout, font fnt, int font_size)
+    {
+        if (INVALID_PTR(layout, TEXT_LAYOUT_PTR))
+        {
+            LOG(WARNING) << "Attempting to set the font of an invalid text layout";
+            return;
+        }
+
+        if (INVALID_PTR(fnt, FONT_PTR))
+        {
+            LOG(WARNING) << "Attempting to set an invalid font on a text layout";
+            return;
+        }
+
+        if (layout->fnt == fnt and layout->font_size == font_size) return;
+
+        layout->fnt = fnt;
+        layout->font_size = font_size;
+        layout->valid = false;
+    }
+
+    void text_layout_set_max_width(text_layout layout, int max_width)
+    {
+        if (INVALID_PTR(layout, TEXT_LAYOUT_PTR))
+        {
+            LOG(WARNING) << "Attempting to set the width of an invalid text layout";
+            return;
+        }
+
+        if (layout->max_width == max_width) return;
+
+        layout->max_width = max_width;
+        layout->valid = false;
+    }
+
+    int text_layout_max_width(text_layout layout)
+    {
+        if (INVALID_PTR(layout, TEXT_LAYOUT_PTR))
+        {
+            LOG(WARNING) << "Attempting to get the width of an invalid text layout";
+            return 0;
+        }
+
+        return layout->max_width;
+    }
+
+    int text_layout_line_count(text_layout layout)
+    {
+        if (not _valid_layout(layout, "count lines")) return 0;
+
+        return static_cast<int>(layout->lines.size());
+    }
+
+    string text_layout_line(text_layout layout, int idx)
+    {
+        if (not _valid_layout(layout, "get a line")) return "";
+
+        if (idx < 0 or idx >= layout->lines.size())
+        {
+            LOG(WARNING) << "Attempting to get line " << idx << " of a text layout with " << layout->lines.size() << " lines";
+            return "";
+        }
+
+        return layout->lines[idx].text;
+    }
+
+    int text_layout_width(text_layout layout)
+    {
+        if (not _valid_layout(layout, "get the width")) return 0;
+
+        return layout->width;
+    }
+
+    int text_layout_height(text_layout layout)
+    {
+        if (not _valid_layout(layout, "get the height")) return 0;
+
+        return layout->line_height * static_cast<int>(layout->lines.size());
+    }
+
+    point_2d text_layout_char_position(text_layout layout, int idx)
+    {
+        if (not _valid_layout(layout, "get a character position")) return point_at(0, 0);
+
+        if (idx < 0 or idx > layout->text.length())
+        {
+            LOG(WARNING) << "Attempting to get the position of character " << idx << " in a text layout of length " << layout->text.length();
+            return point_at(0, 0);
+        }
+
+        // Find the last line that starts at or before idx
+        size_t line = 0;
+        while (line + 1 < layout->lines.size() and layout->lines[line + 1].start <= idx) line++;
+
+        const vector<int> &pos = layout->positions;
+        size_t start = layout->lines[line].start;
+
+        return point_at(pos[idx] - pos[start], static_cast<double>(line * layout->line_height));
+    }
+
+    void draw_text_layout(text_layout layout, const color &clr, double x, double y, const drawing_options &opts)
+    {
+        if (not _valid_layout(layout, "draw")) return;
+
+        for (size_t i = 0; i < layout->lines.size(); i++)
+        {
+            const _text_line &line = layout->lines[i];
+            if (line.text.empty()) continue;
+
+            draw_text(line.text, clr, layout->fnt, layout->font_size, x, y + i * layout->line_height, opts);
+        }
+    }
+
+    void draw_text_layout(text_layout layout, const color &clr, double x, double y)
+    {
+        draw_text_layout(layout, clr, x, y, option_defaults());
+    }
+}
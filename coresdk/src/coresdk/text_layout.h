@@ -0,0 +1,226 @@
+/**
+ * @header  text_layout
+ * @author  Andrew Cain
+ * @brief   Text layouts wrap text to fit within a width, working out the
+ *          line breaks once so the text can be drawn many times.
+ *
+ * @attribute static text_layout
+ * @attribute group  graphics
+ */
+
+#ifndef text_layout_h
+#define text_layout_h
+
+#include "types.h"
+#include "drawing_options.h"
+
+#include <string>
+using std::string;
+
+namespace splashkit_lib
+{
+    /**
+     * A text layout holds text that has been broken into lines to fit within
+     * a maximum width. The line breaks and the position of each character
+     * are worked out once, and are only worked out again when the text, font
+     * or width of the layout changes.
+     *
+     * @attribute class text_layout
+     */
+    typedef struct _text_layout_data *text_layout;
+
+    /**
+     * Creates a text layout that wraps the text to fit within the maximum
+     * width. Lines are broken at spaces where possible, and at the end of
+     * each line of the text.
+     *
+     * @param text          The text to lay out.
+     * @param fnt           The font used to draw the text.
+     * @param font_size     The size of the font.
+     * @param max_width     The width the lines must fit within, or 0 to only
+     *                      break the text at the end of each of its lines.
+     * @returns             The new text layout.
+     *
+     * @attribute class       text_layout
+     * @attribute constructor true
+     */
+    text_layout create_text_layout(const string &text, font fnt, int font_size, int max_width);
+
+    /**
+     * Creates a text layout that wraps the text to fit within the maximum
+     * width. Lines are broken at spaces where possible, and at the end of
+     * each line of the text.
+     *
+     * @param text          The text to lay out.
+     * @param fnt           The name of the font used to draw the text.
+     * @param font_size     The size of the font.
+     * @param max_width     The width the lines must fit within, or 0 to only
+     *                      break the text at the end of each of its lines.
+     * @returns             The new text layout.
+     *
+     * @attribute class       text_layout
+     * @attribute constructor true
+     * @attribute suffix      font_named
+     */
+    text_layout create_text_layout(const string &text, const string &fnt, int font_size, int max_width);
+
+    /**
+     * Frees the text layout.
+     *
+     * @param layout The text layout to free.
+     *
+     * @attribute class      text_layout
+     * @attribute destructor true
+     */
+    void free_text_layout(text_layout layout);
+
+    /**
+     * Changes the text of the layout.
+     *
+     * @param layout The text layout to change.
+     * @param text   The new text to lay out.
+     *
+     * @attribute class  text_layout
+     * @attribute setter text
+     */
+    void text_layout_set_text(text_layout layout, const string &text);
+
+    /**
+     * Returns the text of the layout.
+     *
+     * @param layout The text layout.
+     * @returns      The text being laid out.
+     *
+     * @attribute class  text_layout
+     * @attribute getter text
+     */
+    string text_layout_text(text_layout layout);
+
+    /**
+     * Changes the font and font size used by the layout.
+     *
+     * @param layout    The text layout to change.
+     * @param fnt       The font used to draw the text.
+     * @param font_size The size of the font.
+     *
+     * @attribute class  text_layout
+     * @attribute method set_font
+     */
+    void text_layout_set_font(text_layout layout, font fnt, int font_size);
+
+    /**
+     * Changes the width that the lines of the layout must fit within.
+     *
+     * @param layout    The text layout to change.
+     * @param max_width The width the lines must fit within, or 0 to only
+     *                  break the text at the end of each of its lines.
+     *
+     * @attribute class  text_layout
+     * @attribute setter max_width
+     */
+    void text_layout_set_max_width(text_layout layout, int max_width);
+
+    /**
+     * Returns the width that the lines of the layout must fit within.
+     *
+     * @param layout The text layout.
+     * @returns      The maximum width of the lines.
+     *
+     * @attribute class  text_layout
+     * @attribute getter max_width
+     */
+    int text_layout_max_width(text_layout layout);
+
+    /**
+     * Returns the number of lines the text has been broken into.
+     *
+     * @param layout The text layout.
+     * @returns      The number of lines in the layout.
+     *
+     * @attribute class  text_layout
+     * @attribute getter line_count
+     */
+    int text_layout_line_count(text_layout layout);
+
+    /**
+     * Returns the text of one line of the layout.
+     *
+     * @param layout The text layout.
+     * @param idx    The index of the line, from 0.
+     * @returns      The text on that line.
+     *
+     * @attribute class  text_layout
+     * @attribute method line
+     */
+    string text_layout_line(text_layout layout, int idx);
+
+    /**
+     * Returns the width of the widest line in the layout.
+     *
+     * @param layout The text layout.
+     * @returns      The width of the laid out text.
+     *
+     * @attribute class  text_layout
+     * @attribute getter width
+     */
+    int text_layout_width(text_layout layout);
+
+    /**
+     * Returns the height of all of the lines in the layout.
+     *
+     * @param layout The text layout.
+     * @returns      The height of the laid out text.
+     *
+     * @attribute class  text_layout
+     * @attribute getter height
+     */
+    int text_layout_height(text_layout layout);
+
+    /**
+     * Returns where a character of the text is drawn, relative to the top
+     * left of the layout. This can be used to place a caret or to find the
+     * character under the mouse.
+     *
+     * @param layout The text layout.
+     * @param idx    The index of the character in the text. Use the length
+     *               of the text to get the position after the last character.
+     * @returns      The top left of the character within the layout.
+     *
+     * @attribute class  text_layout
+     * @attribute method char_position
+     */
+    point_2d text_layout_char_position(text_layout layout, int idx);
+
+    /**
+     * Draws the laid out text to the current window, with its top left at
+     * x and y.
+     *
+     * @param layout The text layout to draw.
+     * @param clr    The color of the text.
+     * @param x      The x location to draw the text.
+     * @param y      The y location to draw the text.
+     *
+     * @attribute class  text_layout
+     * @attribute method draw
+     */
+    void draw_text_layout(text_layout layout, const color &clr, double x, double y);
+
+    /**
+     * Draws the laid out text with its top left at x and y, using the
+     * drawing options to pick the destination and camera effect.
+     *
+     * @param layout The text layout to draw.
+     * @param clr    The color of the text.
+     * @param x      The x location to draw the text.
+     * @param y      The y location to draw the text.
+     * @param opts   The `drawing_options` which provide extra information for
+     *               how to draw the text.
+     *
+     * @attribute class  text_layout
+     * @attribute method draw
+     * @attribute suffix with_options
+     */
+    void draw_text_layout(text_layout layout, const color &clr, double x, double y, const drawing_options &opts);
+}
+
+#endif /* text_layout_h */
@@ -207,6 +207,97 @@ namespace splashkit_lib
         point_2d end_point;
     };
 
+    /**
+     * Frame statistics report how well the program is keeping to its target
+     * frame rate. They are gathered from the most recent frames paced with
+     * `refresh_screen` or `refresh_window` using a target fps. All times are
+     * in milliseconds.
+     *
+     * @field frames            The number of frames the statistics cover.
+     * @field mean_frame_time   The average time between frames.
+     * @field p50_frame_time    The median time between frames.
+     * @field p95_frame_time    95% of frames took no longer than this.
+     * @field p99_frame_time    99% of frames took no longer than this.
+     * @field pacing_error      The average difference between each frame
+     *                          time and the target frame time.
+     * @field dropped_frames    The number of frames missed since the
+     *                          statistics were last reset.
+     */
+    struct frame_statistics
+    {
+        int frames;
+        double mean_frame_time;
+        double p50_frame_time;
+        double p95_frame_time;
+        double p99_frame_time;
+        double pacing_error;
+        int dropped_frames;
+    };
+
+    /**
+     * Pool statistics report how the pooled storage for one kind of resource
+     * (such as sprites or animations) is being used.
+     *
+     * @field in_use        The number of objects currently allocated.
+     * @field peak_in_use   The most objects that have been allocated at once.
+     * @field capacity      The number of slots the pool has reserved.
+     * @field allocations   The total number of objects allocated.
+     * @field reuses        The allocations that reused a released slot.
+     * @field releases      The total number of objects released.
+     */
+    struct pool_statistics
+    {
+        int in_use;
+        int peak_in_use;
+        int capacity;
+        int allocations;
+        int reuses;
+        int releases;
+    };
+
+    /**
+     * Resource bundle progress reports how far a resource bundle has got
+     * while it loads in the background. Use it to draw a loading bar.
+     *
+     * @field completed     The number of resources that have been loaded.
+     * @field total         The number of resources in the bundle.
+     * @field bytes_loaded  The size of the files that have been loaded.
+     * @field bytes_total   The size of all of the files in the bundle.
+     * @field done          True once the bundle has finished loading, or
+     *                      when it could not be loaded.
+     * @field failed        True when the bundle could not be loaded, such as
+     *                      when its file is missing.
+     */
+    struct resource_bundle_progress
+    {
+        int completed;
+        int total;
+        int bytes_loaded;
+        int bytes_total;
+        bool done;
+        bool failed;
+    };
+
+    /**
+     * Text cache statistics report how well the cache of rendered text is
+     * working. See `set_text_caching`.
+     *
+     * @field hits      The number of draws that reused cached text.
+     * @field misses    The number of draws that had to render the text.
+     * @field evictions The number of cached strings removed to stay within
+     *                  the budget.
+     * @field entries   The number of strings currently cached.
+     * @field bytes     The memory used by the cached text, in bytes.
+     */
+    struct text_cache_statistics
+    {
+        int hits;
+        int misses;
+        int evictions;
+        int entries;
+        int bytes;
+    };
+
     /**
      * Determines the effect of the camera on a drawing operation.
      *
@@ -345,4 +345,9 @@ namespace splashkit_lib
     {
         return is_request_for(request, HTTP_TRACE_METHOD, path);
     }
+
+    pool_statistics http_request_pool_statistics()
+    {
+        return sk_http_request_pool_statistics();
+    }
 }
@@ -468,5 +468,14 @@ namespace splashkit_lib
      * @attribute method is_trace_request_for
      */
     bool is_trace_request_for(http_request request, const string &path);
+
+    /**
+     * Returns statistics on the pooled storage used for http requests across
+     * all web servers. A request returns its storage to the pool once its
+     * response has been sent.
+     *
+     * @returns The current http request pool statistics.
+     */
+    pool_statistics http_request_pool_statistics();
 }
 #endif /* web_server_h_ */
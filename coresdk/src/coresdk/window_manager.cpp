@@ -21,6 +21,9 @@ using std::map;
 
 namespace splashkit_lib
 {
+    // From images.cpp
+    void _remove_queued_draws_onto(void *dest);
+
     static window _primary_window = nullptr;
     window _current_window = nullptr;
     map<string, window> _windows;
@@ -110,6 +113,28 @@ namespace splashkit_lib
 
         sk_set_icon(&wind->image.surface, &bmp->image.surface);
     }
+
+    void window_set_partial_refresh(window wind, bool partial)
+    {
+        if ( INVALID_PTR(wind, WINDOW_PTR))
+        {
+            LOG(WARNING) << "Attempting to set partial refresh for an invalid window!";
+            return;
+        }
+
+        sk_set_partial_present(&wind->image.surface, partial);
+    }
+
+    bool window_partial_refresh(window wind)
+    {
+        if ( INVALID_PTR(wind, WINDOW_PTR))
+        {
+            LOG(WARNING) << "Attempting to check partial refresh of an invalid window";
+            return false;
+        }
+
+        return sk_partial_present(&wind->image.surface);
+    }
     
     //TODO: From graphics... need to rework...
     void delay_for_target_fps(unsigned int target_fps);
@@ -128,7 +153,7 @@ namespace splashkit_lib
     void refresh_window(window wind, unsigned int target_fps)
     {
         refresh_window(wind);
-        delay_for_target_fps(60);
+        delay_for_target_fps(target_fps);
     }
 
     void clear_window(window wind, color clr)
@@ -151,6 +176,7 @@ namespace splashkit_lib
         }
 
         notify_of_free(wind);
+        _remove_queued_draws_onto(wind);
 
         if ( wind == _current_window )
             _current_window = _primary_window;
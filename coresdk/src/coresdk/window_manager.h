@@ -293,6 +293,33 @@ namespace splashkit_lib
      */
     void window_set_icon(window wind, bitmap bmp);
 
+    /**
+     * Sets if refreshing the window is skipped when nothing was drawn on it
+     * since the last refresh. This reduces the work done by the graphics
+     * card for windows that only change now and then, like dashboards and
+     * displays.
+     *
+     * @param wind    The window to change
+     * @param partial Pass in `true` to skip refreshes when nothing changed,
+     *                or `false` to refresh the whole window each time
+     *
+     * @attribute class   window
+     * @attribute setter  partial_refresh
+     */
+    void window_set_partial_refresh(window wind, bool partial);
+
+    /**
+     * Checks if refreshing the window is skipped when nothing was drawn on
+     * it since the last refresh.
+     *
+     * @param wind The window to check
+     * @return     True if unchanged refreshes are skipped
+     *
+     * @attribute class   window
+     * @attribute getter  partial_refresh
+     */
+    bool window_partial_refresh(window wind);
+
     /**
      * Change the size of the window.
      *
@@ -13,12 +13,29 @@
 #include "utils.h"
 #include "audio.h"
 #include "input.h"
+#include "backend_types.h"
 
 #include <vector>
 #include <iostream>
 using namespace std;
 using namespace splashkit_lib;
 
+// Looping back to a frame part way through the animation should follow on
+// from its last frame
+void test_loop_last_frame(animation_script kermit)
+{
+    animation anim = create_animation(kermit, "StandThenWalk", false);
+
+    // The stand and four walk frames take 60, so this wraps to the first walk
+    update_animation(anim, 60.0f, false);
+    cout << "Looped to cell " << animation_current_cell(anim) << " (should be 0) after cell " << anim->last_frame->cell_index << " (should be 3)" << endl;
+
+    update_animation(anim, 12.0f, false);
+    cout << "Moved to cell " << animation_current_cell(anim) << " (should be 1) after cell " << anim->last_frame->cell_index << " (should be 0)" << endl;
+
+    free_animation(anim);
+}
+
 void run_animation_test()
 {
     vector<string> sequence = { "Walkfront", "WalkLeft", "WalkRight", "WALKBACK", "dance" };
@@ -28,8 +45,16 @@ void run_animation_test()
     animation_script kermit = load_animation_script("kermit", "kermit.txt");
     
     cout << "Script should be loaded: " << has_animation_script("kermit");
+
+    test_loop_last_frame(kermit);
     
     animation anim = create_animation(kermit, "MoonWalkBack");
+
+    // Updated only every 4th frame, but by 4 frames' worth of time, so it
+    // should stay in step with anim
+    animation catch_up = create_animation(kermit, "MoonWalkBack", false);
+    vector<animation> batch = { catch_up };
+    int frame = 0;
     
     open_window("Test Animation", 600, 600);
     
@@ -45,14 +70,20 @@ void run_animation_test()
         clear_screen(COLOR_WHITE);
         
         draw_bitmap(frog, 100, 100, option_with_animation(anim));
+        draw_bitmap(frog, 300, 100, option_with_animation(catch_up));
         
         update_animation(anim);
+
+        frame++;
+        if ( frame % 4 == 0 ) update_animations(batch, 4.0f, false);
         
         if ( animation_ended(anim) )
         {
             if ( it == sequence.end() ) break;
             
             assign_animation(anim, kermit, *it);
+            assign_animation(catch_up, kermit, *it, false);
+            frame = 0;
             
             it++;
         }
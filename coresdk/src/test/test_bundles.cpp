@@ -14,6 +14,9 @@
 #include "images.h"
 #include "timers.h"
 #include "text.h"
+#include "graphics.h"
+#include "input.h"
+#include "color.h"
 
 #include <iostream>
 using namespace std;
@@ -67,5 +70,31 @@ void run_bundle_test()
     cout << "  Bundle:      " << has_resource_bundle("blah") << endl;
     cout << "  Ufo:         " << has_bitmap("ufo") << endl;
     cout << "  Bundle test: " << has_resource_bundle("test") << endl;
-    
-}
\ No newline at end of file
+
+    // Load the bundle in the background, drawing a loading bar as it goes
+    window wnd = open_window("Loading Bundle", 400, 100);
+
+    load_resource_bundle_async("test", "test.txt");
+
+    resource_bundle_progress progress = resource_bundle_load_progress("test");
+    while ( not progress.done and not quit_requested() )
+    {
+        process_events();
+        clear_screen(COLOR_WHITE);
+
+        double pct = progress.bytes_total > 0 ? progress.bytes_loaded / (double)progress.bytes_total : 0;
+        fill_rectangle(COLOR_GREEN, 20, 40, 360 * pct, 20);
+        draw_rectangle(COLOR_BLACK, 20, 40, 360, 20);
+        draw_text(to_string(progress.completed) + " of " + to_string(progress.total) + " resources", COLOR_BLACK, 20, 70);
+
+        refresh_screen(60);
+        progress = resource_bundle_load_progress("test");
+    }
+
+    wait_for_resource_bundle("test");
+    cout << "After async loading:" << endl;
+    cout << "  Bundle test: " << has_resource_bundle("test") << (progress.failed ? " failed" : "") << " (" << progress.completed << " of " << progress.total << ", " << progress.bytes_loaded << " bytes)" << endl;
+
+    free_resource_bundle("test");
+    close_window(wnd);
+}
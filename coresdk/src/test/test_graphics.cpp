@@ -15,6 +15,7 @@
 #include "utils.h"
 
 #include <iostream>
+#include <cmath>
 using namespace std;
 using namespace splashkit_lib;
 
@@ -105,6 +106,61 @@ void test_clipping(window w1)
     delay(3000);
 }
 
+void test_deferred_drawing(window w1)
+{
+    color clr;
+
+    set_deferred_drawing(true);
+
+    for (int i = 0; i < 120 and not window_close_requested(w1); i++)
+    {
+        process_events();
+        clear_window(w1, COLOR_WHITE);
+
+        for (int x = 0; x < window_width(w1); x += 2)
+        {
+            for (int y = 0; y < window_height(w1); y += 2)
+            {
+                clr = hsb_color(x / (window_width(w1) * 1.0f), y / (window_height(w1) * 1.0f), 0.8);
+                fill_rectangle(clr, x, y, 2, 2);
+            }
+        }
+
+        fill_circle(COLOR_RED, 150, 150, 50);
+        draw_text("Deferred: " + to_string(deferred_drawing()), COLOR_BLACK, 10, 10);
+        draw_line(COLOR_BLACK, 0, 300, 300, 0);
+
+        refresh_screen();
+    }
+
+    set_deferred_drawing(false);
+}
+
+void test_frame_pacing(window w1)
+{
+    unsigned int rates[] = { 30, 60, 120, 144 };
+
+    for (unsigned int fps : rates)
+    {
+        reset_frame_statistics();
+
+        for (unsigned int i = 0; i < 2 * fps and not window_close_requested(w1); i++)
+        {
+            process_events();
+            clear_window(w1, COLOR_WHITE);
+            fill_circle(COLOR_RED, 150 + 100 * sin(i * 0.05), 150, 20);
+            draw_text("Pacing at " + to_string(fps) + " fps", COLOR_BLACK, 10, 10);
+            refresh_screen(fps);
+        }
+
+        frame_statistics stats = current_frame_statistics();
+        cout << fps << " fps over " << stats.frames << " frames: mean " << stats.mean_frame_time
+             << "ms, p50 " << stats.p50_frame_time << "ms, p95 " << stats.p95_frame_time
+             << "ms, p99 " << stats.p99_frame_time << "ms, error " << stats.pacing_error
+             << "ms, dropped " << stats.dropped_frames << endl;
+    }
+}
+
 void run_graphics_test()
 {
     cout << "Checking the number of displays and their details" << endl;
@@ -126,6 +182,8 @@ void run_graphics_test()
     window w1 = open_window("Testing Graphics", 300, 300);
     
     test_clipping(w1);
+    test_deferred_drawing(w1);
+    test_frame_pacing(w1);
     
     color in_clr = string_to_color("#ffeebbaa");
     
@@ -101,6 +101,11 @@ void test_circle_drawing(window w1)
     cout << "Saving circles bitmap to desktop" << endl;
     save_bitmap(bmp, "circle bitmap");
     
+    cout << "Saving circles bitmap to desktop in the background" << endl;
+    save_bitmap_in_background(bmp, "circle bitmap background");
+    cout << images_being_saved() << " image(s) being saved" << endl;
+    wait_for_images_to_save();
+    
     free_bitmap(bmp);
     free_timer(t);
 }
@@ -474,6 +479,52 @@ void test_line_drawing(window w1)
     free_timer(t);
 }
 
+void test_instanced_drawing(window w1)
+{
+    timer t = create_timer("instanced drawing timer");
+    start_timer(t);
+
+    vector<circle> particles;
+    vector<rectangle> tiles;
+    vector<line> lines;
+    vector<color> clrs;
+
+    for (int i = 0; i < 10000; i++)
+    {
+        particles.push_back(circle_at(random_screen_point(), rnd(4) + 1));
+        clrs.push_back(random_rgb_color(128));
+    }
+
+    for (int x = 0; x < screen_width(); x += 20)
+        for (int y = 0; y < screen_height(); y += 20)
+            tiles.push_back(rectangle_from(x + 1, y + 1, 18, 18));
+
+    for (int i = 0; i < 100; i++)
+        lines.push_back(line_from(random_screen_point(), random_screen_point()));
+
+    while( not window_close_requested(w1) and timer_ticks(t) < 3000 )
+    {
+        process_events();
+
+        clear_screen(COLOR_WHITE);
+        fill_rectangles({ COLOR_WHEAT }, tiles);
+
+        for (circle &c : particles)
+        {
+            c.center.x += rnd() * 2 - 1;
+            c.center.y += rnd() * 2 - 1;
+        }
+        fill_circles(clrs, particles);
+
+        draw_lines({ COLOR_BLACK }, lines);
+        draw_text("Instanced: 10000 circles", COLOR_TOMATO, "myfont", 18, 30, 30);
+
+        refresh_screen();
+    }
+
+    free_timer(t);
+}
+
 
 void run_shape_drawing_test()
 {
@@ -487,6 +538,7 @@ void run_shape_drawing_test()
     test_quad_drawing(w1);
     test_ellipse_drawing(w1);
     test_line_drawing(w1);
+    test_instanced_drawing(w1);
     
     close_window(w1);
 }
\ No newline at end of file
@@ -6,16 +6,148 @@
 //  Copyright © 2016 Andrew Cain. All rights reserved.
 //
 
+#include "camera.h"
 #include "collisions.h"
 #include "geometry.h"
 #include "graphics.h"
 #include "images.h"
 #include "input.h"
 #include "sprites.h"
+#include "text.h"
 #include "window_manager.h"
 
+#include <cstdlib>
+#include <iostream>
+using namespace std;
 using namespace splashkit_lib;
 
+sprite create_crowd_sprite()
+{
+    sprite s = create_sprite(bitmap_named("ufo.png"));
+    sprite_set_x(s, rand() % 600);
+    sprite_set_y(s, rand() % 600);
+    sprite_set_velocity(s, vector_to((rand() % 21 - 10) / 10.0, (rand() % 21 - 10) / 10.0));
+    sprite_set_collision_kind(s, AABB_COLLISIONS);
+    return s;
+}
+
+void test_sprite_pack_collisions()
+{
+    create_sprite_pack("crowd");
+    select_sprite_pack("crowd");
+
+    vector<sprite> crowd;
+    for (int i = 0; i < 2000; i++)
+    {
+        crowd.push_back(create_crowd_sprite());
+    }
+
+    bool parallel = false;
+    bool queued = false;
+    bool churn = false;
+
+    while ( not quit_requested() and not key_typed(ESCAPE_KEY) )
+    {
+        process_events();
+        clear_screen(COLOR_WHITE);
+
+        if ( key_typed(P_KEY) ) parallel = not parallel;
+        if ( key_typed(Q_KEY) ) queued = not queued;
+        if ( key_typed(C_KEY) ) churn = not churn;
+        if ( key_down(LEFT_KEY) ) move_camera_by(-4, 0);
+        if ( key_down(RIGHT_KEY) ) move_camera_by(4, 0);
+
+        if ( churn )
+        {
+            // Replace 100 sprites a frame, which should reuse pooled storage
+            for (int i = 0; i < 100; i++)
+            {
+                int idx = rand() % crowd.size();
+                free_sprite(crowd[idx]);
+                crowd[idx] = create_crowd_sprite();
+            }
+        }
+
+        if ( parallel )
+            update_all_sprites_in_parallel();
+        else
+            update_all_sprites();
+
+        if ( queued )
+        {
+            queue_all_sprites(0);
+            draw_render_queue();
+        }
+        else
+            draw_all_sprites();
+
+        vector<sprite_pair> hits = sprite_pack_collisions();
+        for (const sprite_pair &hit : hits)
+        {
+            draw_line(COLOR_RED, center_point(hit.first), center_point(hit.second));
+        }
+
+        point_2d mouse = to_world(mouse_position());
+        rectangle area = rectangle_from(mouse.x - 100, mouse.y - 100, 200, 200);
+        draw_rectangle(COLOR_BLUE, area);
+        for (sprite s : sprites_in_rectangle(area))
+        {
+            draw_rectangle(COLOR_BLUE, sprite_collision_rectangle(s));
+        }
+
+        draw_text(to_string(hits.size()) + " collisions", COLOR_BLACK, 10, 10, option_to_screen());
+        draw_text(parallel ? "Parallel update (P to toggle)" : "Serial update (P to toggle)", COLOR_BLACK, 10, 20, option_to_screen());
+        draw_text(to_string(sprites_drawn_count()) + " drawn, " + to_string(sprites_culled_count()) + " culled", COLOR_BLACK, 10, 30, option_to_screen());
+        draw_text(queued ? "Render queue (Q to toggle)" : "Immediate drawing (Q to toggle)", COLOR_BLACK, 10, 40, option_to_screen());
+        pool_statistics pool = sprite_pool_statistics();
+        draw_text(to_string(pool.in_use) + " of " + to_string(pool.capacity) + " pooled sprites, " + to_string(pool.reuses) + " reused" + (churn ? " (C to stop churn)" : " (C to churn)"), COLOR_BLACK, 10, 50, option_to_screen());
+        reset_sprite_draw_counts();
+        refresh_screen(60);
+    }
+
+    free_sprite_pack("crowd");
+    select_sprite_pack("default");
+    set_camera_position(point_at(0, 0));
+}
+
+//
+// Check collisions right at the edges of solid bitmaps
+//
+void test_collision_edges()
+{
+    bitmap solid = create_bitmap("solid", 20, 20);
+    clear_bitmap(solid, COLOR_BLACK);
+    setup_collision_mask(solid);
+
+    sprite s = create_sprite(solid);
+    sprite_set_x(s, 100);
+    sprite_set_y(s, 100);
+
+    cout << "Point 0.5px left of sprite:   " << (sprite_point_collision(s, point_at(99.5, 110)) ? "hit (FAIL)" : "miss (ok)") << endl;
+    cout << "Point 0.5px above sprite:     " << (sprite_point_collision(s, point_at(110, 99.5)) ? "hit (FAIL)" : "miss (ok)") << endl;
+    cout << "Point 0.5px inside sprite:    " << (sprite_point_collision(s, point_at(100.5, 100.5)) ? "hit (ok)" : "miss (FAIL)") << endl;
+
+    // A 360 degree rotation is not exactly the identity, so it takes the
+    // general path -- both paths must agree at the edge, for offsets in (-1, 0)
+    bitmap small = create_bitmap("small_solid", 10, 10);
+    clear_bitmap(small, COLOR_BLACK);
+    setup_collision_mask(small);
+
+    for (double x : { 89.5, 90.5, 119.5, 120.5 })
+    {
+        matrix_2d moved = translation_matrix(x, 100.7);
+        matrix_2d rotated = matrix_multiply(moved, rotation_matrix(360));
+        bool fast = bitmap_collision(small, 0, moved, solid, 0, translation_matrix(100, 100));
+        bool general = bitmap_collision(small, 0, rotated, solid, 0, translation_matrix(100, 100));
+
+        cout << "Bitmap at x " << x << ": moved " << fast << ", rotated " << general << (fast == general ? " (ok)" : " (FAIL)") << endl;
+    }
+
+    free_bitmap(small);
+    free_sprite(s);
+    free_bitmap(solid);
+}
+
 void run_sprite_test()
 {
     sprite sprt, s2;
@@ -25,6 +157,9 @@ void run_sprite_test()
     quad q;
 
     open_window("Sprite Rotation", 600, 600);
+
+    test_collision_edges();
+    test_sprite_pack_collisions();
     
     hide_mouse();
 
@@ -7,6 +7,7 @@
 //
 
 #include "text.h"
+#include "text_layout.h"
 #include "graphics.h"
 #include "input.h"
 #include "color.h"
@@ -102,6 +103,70 @@ void test_font_auto_load()
 
 }
 
+void test_text_hud()
+{
+    font fnt = font_named("leaguegothic");
+    int frame = 0;
+
+    // Redraws lots of changing text each frame, as a HUD or scoreboard would
+    while ( not quit_requested() and not key_typed(ESCAPE_KEY) )
+    {
+        process_events();
+        clear_screen(COLOR_WHITE);
+
+        for (int i = 0; i < 30; i++)
+        {
+            color clr = hsb_color((frame + i * 10) % 360 / 360.0, 0.8, 0.8);
+            draw_text("Score: " + to_string(frame * 10 + i) + " - Lives: " + to_string(i % 4), clr, fnt, 18, 10 + (i % 3) * 260, 10 + (i / 3) * 20);
+        }
+
+        if ( key_typed(C_KEY) ) set_text_caching(not text_caching());
+
+        // Static labels suit the text cache
+        for (int i = 0; i < 10; i++)
+        {
+            draw_text("Label " + to_string(i), COLOR_DARK_BLUE, fnt, 18, 10 + i * 70, 240);
+        }
+
+        frame_statistics stats = current_frame_statistics();
+        text_cache_statistics cache = current_text_cache_statistics();
+        draw_text("Mean frame time: " + to_string(stats.mean_frame_time) + "ms (ESC to continue)", COLOR_BLACK, fnt, 18, 10, 560);
+        draw_text(string(text_caching() ? "Cached text" : "Glyph text") + " (C to toggle): " + to_string(cache.hits) + " hits, " + to_string(cache.misses) + " misses, " + to_string(cache.evictions) + " evictions, " + to_string(cache.bytes / 1024) + "KB", COLOR_BLACK, fnt, 18, 10, 540);
+
+        refresh_screen(60);
+        frame++;
+    }
+
+    set_text_caching(false);
+    clear_text_cache();
+}
+
+void test_text_layout()
+{
+    text_layout layout = create_text_layout(
+        "SplashKit text layouts wrap text to fit within a width. The line breaks are "
+        "worked out once, and only again when the text, font or width changes.\n\n"
+        "Move the mouse left and right to change the width of the layout.",
+        "leaguegothic", 20, 400);
+
+    while ( not quit_requested() and not key_typed(ESCAPE_KEY) )
+    {
+        process_events();
+        clear_screen(COLOR_WHITE);
+
+        int width = static_cast<int>(mouse_x()) - 20;
+        text_layout_set_max_width(layout, width > 20 ? width : 20);
+
+        draw_rectangle(COLOR_LIGHT_GRAY, 20, 20, text_layout_max_width(layout), text_layout_height(layout));
+        draw_text_layout(layout, COLOR_BLACK, 20, 20);
+
+        draw_text(to_string(text_layout_line_count(layout)) + " lines, " + to_string(text_layout_width(layout)) + " wide (ESC to continue)", COLOR_BLACK, 20, 580);
+        refresh_screen(60);
+    }
+
+    free_text_layout(layout);
+}
+
 void run_text_test()
 {
     open_window("Test Text", 800, 600);
@@ -121,6 +186,9 @@ void run_text_test()
     refresh_screen();
     delay(5000);
 
+    test_text_hud();
+    test_text_layout();
+
     close_window(window_named("Test Text"));
     free_all_fonts();
 }
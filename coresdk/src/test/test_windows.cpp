@@ -19,6 +19,45 @@
 using namespace std;
 using namespace splashkit_lib;
 
+//
+// Draw onto a bitmap shown in two windows, then close the window that owns
+// it. The other window must still be able to draw onto the bitmap.
+//
+void test_bitmap_owner_change()
+{
+    window w1 = open_window("Bitmap Owner", 300, 200);
+    window w2 = open_window("Bitmap Copy", 300, 200);
+
+    bitmap bmp = load_bitmap("owner_test", "on_med.png");
+
+    // Both windows get the loaded bitmap, then the owner is drawn onto
+    draw_bitmap(bmp, 0, 0, option_draw_to(w1));
+    draw_bitmap(bmp, 0, 0, option_draw_to(w2));
+    fill_circle(COLOR_RED, 10, 10, 10, option_draw_to(bmp));
+
+    // The second window now refreshes its copy
+    draw_bitmap(bmp, 0, 0, option_draw_to(w2));
+    refresh_window(w1);
+    refresh_window(w2);
+
+    close_window(w1);
+
+    fill_circle(COLOR_BLUE, 40, 10, 10, option_draw_to(bmp));
+
+    // Closing the first window asks to quit, so watch the second window
+    while ( ! window_close_requested(w2) and ! key_typed(ESCAPE_KEY) )
+    {
+        process_events();
+        clear_window(w2, COLOR_WHITE);
+        draw_bitmap(bmp, 10, 10, option_draw_to(w2));
+        draw_text("Expect a red and a blue circle (ESC to end)", COLOR_BLACK, 10, 180, option_draw_to(w2));
+        refresh_window(w2);
+    }
+
+    free_bitmap(bmp);
+    close_window(w2);
+}
+
 void run_windows_tests()
 {
     window w1 = open_window("Hello World", 800, 600);
@@ -39,6 +78,12 @@ void run_windows_tests()
     {
         process_events();
         
+        if ( key_typed(P_KEY) )
+        {
+            window_set_partial_refresh(w1, not window_partial_refresh(w1));
+            cout << "Partial refresh: " << (window_partial_refresh(w1) ? "on" : "off") << endl;
+        }
+        
         draw_circle(COLOR_RED, 10, 10, 10);
         fill_circle(COLOR_GREEN, 50, 10, 10);
         
@@ -55,4 +100,6 @@ void run_windows_tests()
     close_window(window_named("Hello World"));
     
     delay(500);
+
+    test_bitmap_owner_change();
 }
@@ -7,6 +7,7 @@
 #include "catch.hpp"
 
 #include "text.h"
+#include "text_layout.h"
 #include "types.h"
 #include "backend_types.h"
 #include "utility_functions.h"
@@ -28,3 +29,157 @@ TEST_CASE("can load system fonts", "[text]")
         REQUIRE(VALID_PTR(test, FONT_PTR));
     }
 }
+
+TEST_CASE("text layouts wrap text to fit their width", "[text]")
+{
+    font fnt;
+    #ifndef __linux__
+    fnt = load_font("Arial", "Arial");
+    #else
+    fnt = load_font("Arial", "DejaVuSans.ttf");
+    #endif
+
+    REQUIRE(VALID_PTR(fnt, FONT_PTR));
+
+    SECTION("breaks at the end of each line of the text")
+    {
+        text_layout layout = create_text_layout("one\ntwo\n\nthree", fnt, 20, 0);
+
+        REQUIRE(text_layout_line_count(layout) == 4);
+        REQUIRE(text_layout_line(layout, 0) == "one");
+        REQUIRE(text_layout_line(layout, 1) == "two");
+        REQUIRE(text_layout_line(layout, 2) == "");
+        REQUIRE(text_layout_line(layout, 3) == "three");
+
+        free_text_layout(layout);
+    }
+
+    SECTION("wraps words at spaces, dropping the space at the end of the line")
+    {
+        int max_width = text_width("hello wor", fnt, 20);
+        text_layout layout = create_text_layout("hello world", fnt, 20, max_width);
+
+        REQUIRE(text_layout_line_count(layout) == 2);
+        REQUIRE(text_layout_line(layout, 0) == "hello");
+        REQUIRE(text_layout_line(layout, 1) == "world");
+        REQUIRE(text_layout_width(layout) <= max_width);
+
+        free_text_layout(layout);
+    }
+
+    SECTION("splits words that are wider than the line")
+    {
+        int max_width = text_width("abcde", fnt, 20);
+        string text = "abcdefghijklmnop";
+        text_layout layout = create_text_layout(text, fnt, 20, max_width);
+
+        REQUIRE(text_layout_line_count(layout) > 1);
+        REQUIRE(text_layout_width(layout) <= max_width);
+
+        string joined;
+        for (int i = 0; i < text_layout_line_count(layout); i++)
+        {
+            joined += text_layout_line(layout, i);
+        }
+        REQUIRE(joined == text);
+
+        free_text_layout(layout);
+    }
+
+    SECTION("splits a long word after wrapping it onto a new line")
+    {
+        // The narrow first word lets the wide word grow past the width
+        // before it is wrapped
+        int max_width = text_width("WWW", fnt, 20) - 2;
+        text_layout layout = create_text_layout("i WWWWWWWW", fnt, 20, max_width);
+
+        REQUIRE(text_layout_line(layout, 0) == "i");
+        REQUIRE(text_layout_line_count(layout) > 2);
+        REQUIRE(text_layout_width(layout) <= max_width);
+
+        free_text_layout(layout);
+    }
+
+    SECTION("gives the position of characters within the layout")
+    {
+        text_layout layout = create_text_layout("one\none", fnt, 20, 0);
+        double line_height = text_layout_height(layout) / 2.0;
+
+        point_2d first = text_layout_char_position(layout, 0);
+        REQUIRE(first.x == 0);
+        REQUIRE(first.y == 0);
+
+        point_2d second_line = text_layout_char_position(layout, 4);
+        REQUIRE(second_line.x == 0);
+        REQUIRE(second_line.y == line_height);
+
+        point_2d after_o = text_layout_char_position(layout, 1);
+        REQUIRE(after_o.x > 0);
+        REQUIRE(after_o.y == 0);
+
+        point_2d end = text_layout_char_position(layout, 7);
+        REQUIRE(end.x == text_layout_width(layout));
+        REQUIRE(end.y == line_height);
+
+        free_text_layout(layout);
+    }
+}
+
+TEST_CASE("text is measured from the same metrics as its characters", "[text]")
+{
+    font fnt;
+    #ifndef __linux__
+    fnt = load_font("Arial", "Arial");
+    #else
+    fnt = load_font("Arial", "DejaVuSans.ttf");
+    #endif
+
+    REQUIRE(VALID_PTR(fnt, FONT_PTR));
+
+    SECTION("gives the end of the last character as the width of UTF-8 text")
+    {
+        string text = "héllo wörld";
+        text_layout layout = create_text_layout(text, fnt, 20, 0);
+
+        point_2d end = text_layout_char_position(layout, static_cast<int>(text.length()));
+        REQUIRE(end.x == text_width(text, fnt, 20));
+        REQUIRE(text_layout_width(layout) == text_width(text, fnt, 20));
+
+        free_text_layout(layout);
+    }
+
+    SECTION("gives the same size when text is measured again")
+    {
+        int width = text_width("hello world", fnt, 20);
+        int height = text_height("hello world", fnt, 20);
+
+        REQUIRE(text_width("hello world", fnt, 20) == width);
+        REQUIRE(text_height("hello world", fnt, 20) == height);
+    }
+
+    SECTION("measures text again when the font style changes")
+    {
+        int normal = text_width("hello world", fnt, 20);
+
+        set_font_style(fnt, BOLD_FONT);
+        int bold = text_width("hello world", fnt, 20);
+
+        set_font_style(fnt, NORMAL_FONT);
+        REQUIRE(bold > normal);
+        REQUIRE(text_width("hello world", fnt, 20) == normal);
+    }
+
+    SECTION("measures text again when the font is reloaded")
+    {
+        int width = text_width("hello world", fnt, 20);
+
+        free_font(fnt);
+        #ifndef __linux__
+        fnt = load_font("Arial", "Arial");
+        #else
+        fnt = load_font("Arial", "DejaVuSans.ttf");
+        #endif
+
+        REQUIRE(text_width("hello world", fnt, 20) == width);
+    }
+}
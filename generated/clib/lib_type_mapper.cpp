@@ -701,3 +701,99 @@ void __sklib__update_from_vector_bool(const std::vector<bool> &v, __sklib_vector
         i++;
     }
 }
+extern "C" void __sklib__free__sklib_vector_color(__sklib_vector_color v) {
+    free(v.data_from_lib);
+}
+__sklib_vector_color __sklib__to_sklib_vector_color(const std::vector<color> &v) {
+    __sklib_vector_color __skreturn;
+    __skreturn.size_from_app = 0;
+    __skreturn.data_from_app = nullptr;
+    __skreturn.size_from_lib = static_cast<unsigned int>(v.size());
+    __skreturn.data_from_lib = (__sklib_color *)malloc(__skreturn.size_from_lib * sizeof(__sklib_color));
+    unsigned int i = 0;
+    for (color d : v) {
+        __skreturn.data_from_lib[i] = __sklib__to_sklib_color(d);
+        i++;
+    }
+    return __skreturn;
+}
+vector<color> __sklib__to_vector_color(const __sklib_vector_color &v) {
+    vector<color> __skreturn;
+    for (int i = 0; i < v.size_from_app; i++) {
+        __skreturn.push_back(__sklib__to_color(v.data_from_app[i]));
+    }
+    return __skreturn;
+}
+void __sklib__update_from_vector_color(const std::vector<color> &v, __sklib_vector_color *__skreturn) {
+    __skreturn->size_from_lib = static_cast<unsigned int>(v.size());
+    __skreturn->data_from_lib = (__sklib_color *)malloc(__skreturn->size_from_lib * sizeof(__sklib_color));
+    unsigned int i = 0;
+    for (color d : v) {
+        __skreturn->data_from_lib[i] = __sklib__to_sklib_color(d);
+        i++;
+    }
+}
+extern "C" void __sklib__free__sklib_vector_circle(__sklib_vector_circle v) {
+    free(v.data_from_lib);
+}
+__sklib_vector_circle __sklib__to_sklib_vector_circle(const std::vector<circle> &v) {
+    __sklib_vector_circle __skreturn;
+    __skreturn.size_from_app = 0;
+    __skreturn.data_from_app = nullptr;
+    __skreturn.size_from_lib = static_cast<unsigned int>(v.size());
+    __skreturn.data_from_lib = (__sklib_circle *)malloc(__skreturn.size_from_lib * sizeof(__sklib_circle));
+    unsigned int i = 0;
+    for (circle d : v) {
+        __skreturn.data_from_lib[i] = __sklib__to_sklib_circle(d);
+        i++;
+    }
+    return __skreturn;
+}
+vector<circle> __sklib__to_vector_circle(const __sklib_vector_circle &v) {
+    vector<circle> __skreturn;
+    for (int i = 0; i < v.size_from_app; i++) {
+        __skreturn.push_back(__sklib__to_circle(v.data_from_app[i]));
+    }
+    return __skreturn;
+}
+void __sklib__update_from_vector_circle(const std::vector<circle> &v, __sklib_vector_circle *__skreturn) {
+    __skreturn->size_from_lib = static_cast<unsigned int>(v.size());
+    __skreturn->data_from_lib = (__sklib_circle *)malloc(__skreturn->size_from_lib * sizeof(__sklib_circle));
+    unsigned int i = 0;
+    for (circle d : v) {
+        __skreturn->data_from_lib[i] = __sklib__to_sklib_circle(d);
+        i++;
+    }
+}
+extern "C" void __sklib__free__sklib_vector_rectangle(__sklib_vector_rectangle v) {
+    free(v.data_from_lib);
+}
+__sklib_vector_rectangle __sklib__to_sklib_vector_rectangle(const std::vector<rectangle> &v) {
+    __sklib_vector_rectangle __skreturn;
+    __skreturn.size_from_app = 0;
+    __skreturn.data_from_app = nullptr;
+    __skreturn.size_from_lib = static_cast<unsigned int>(v.size());
+    __skreturn.data_from_lib = (__sklib_rectangle *)malloc(__skreturn.size_from_lib * sizeof(__sklib_rectangle));
+    unsigned int i = 0;
+    for (rectangle d : v) {
+        __skreturn.data_from_lib[i] = __sklib__to_sklib_rectangle(d);
+        i++;
+    }
+    return __skreturn;
+}
+vector<rectangle> __sklib__to_vector_rectangle(const __sklib_vector_rectangle &v) {
+    vector<rectangle> __skreturn;
+    for (int i = 0; i < v.size_from_app; i++) {
+        __skreturn.push_back(__sklib__to_rectangle(v.data_from_app[i]));
+    }
+    return __skreturn;
+}
+void __sklib__update_from_vector_rectangle(const std::vector<rectangle> &v, __sklib_vector_rectangle *__skreturn) {
+    __skreturn->size_from_lib = static_cast<unsigned int>(v.size());
+    __skreturn->data_from_lib = (__sklib_rectangle *)malloc(__skreturn->size_from_lib * sizeof(__sklib_rectangle));
+    unsigned int i = 0;
+    for (rectangle d : v) {
+        __skreturn->data_from_lib[i] = __sklib__to_sklib_rectangle(d);
+        i++;
+    }
+}
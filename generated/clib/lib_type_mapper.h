@@ -203,5 +203,14 @@ void __sklib__update_from_vector_json(const std::vector<json> &v, __sklib_vector
 __sklib_vector_bool __sklib__to_sklib_vector_bool(const std::vector<bool> &v);
 vector<bool> __sklib__to_vector_bool(const __sklib_vector_bool &v);
 void __sklib__update_from_vector_bool(const std::vector<bool> &v, __sklib_vector_bool *__skreturn);
+__sklib_vector_color __sklib__to_sklib_vector_color(const std::vector<color> &v);
+vector<color> __sklib__to_vector_color(const __sklib_vector_color &v);
+void __sklib__update_from_vector_color(const std::vector<color> &v, __sklib_vector_color *__skreturn);
+__sklib_vector_circle __sklib__to_sklib_vector_circle(const std::vector<circle> &v);
+vector<circle> __sklib__to_vector_circle(const __sklib_vector_circle &v);
+void __sklib__update_from_vector_circle(const std::vector<circle> &v, __sklib_vector_circle *__skreturn);
+__sklib_vector_rectangle __sklib__to_sklib_vector_rectangle(const std::vector<rectangle> &v);
+vector<rectangle> __sklib__to_vector_rectangle(const __sklib_vector_rectangle &v);
+void __sklib__update_from_vector_rectangle(const std::vector<rectangle> &v, __sklib_vector_rectangle *__skreturn);
 
 #endif /* __splashkit_lib_type_mapper */
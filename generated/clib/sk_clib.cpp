@@ -422,6 +422,17 @@ void __sklib__fill_circle_on_window__window__color__double__double__double__draw
     drawing_options __skparam__opts = __sklib__to_drawing_options(opts);
     fill_circle_on_window(__skparam__destination, __skparam__clr, __skparam__x, __skparam__y, __skparam__radius, __skparam__opts);
 }
+void __sklib__fill_circles__vector_color_ref__vector_circle_ref(const __sklib_vector_color clrs, const __sklib_vector_circle circles) {
+    vector<color> __skparam__clrs = __sklib__to_vector_color(clrs);
+    vector<circle> __skparam__circles = __sklib__to_vector_circle(circles);
+    fill_circles(__skparam__clrs, __skparam__circles);
+}
+void __sklib__fill_circles__vector_color_ref__vector_circle_ref__drawing_options(const __sklib_vector_color clrs, const __sklib_vector_circle circles, __sklib_drawing_options opts) {
+    vector<color> __skparam__clrs = __sklib__to_vector_color(clrs);
+    vector<circle> __skparam__circles = __sklib__to_vector_circle(circles);
+    drawing_options __skparam__opts = __sklib__to_drawing_options(opts);
+    fill_circles(__skparam__clrs, __skparam__circles, __skparam__opts);
+}
 unsigned int __sklib__current_ticks() {
     unsigned int __skreturn = current_ticks();
     return __sklib__to_unsigned_int(__skreturn);
@@ -1246,6 +1257,17 @@ void __sklib__fill_rectangle_on_window__window__color__double__double__double__d
     drawing_options __skparam__opts = __sklib__to_drawing_options(opts);
     fill_rectangle_on_window(__skparam__destination, __skparam__clr, __skparam__x, __skparam__y, __skparam__width, __skparam__height, __skparam__opts);
 }
+void __sklib__fill_rectangles__vector_color_ref__vector_rectangle_ref(const __sklib_vector_color clrs, const __sklib_vector_rectangle rects) {
+    vector<color> __skparam__clrs = __sklib__to_vector_color(clrs);
+    vector<rectangle> __skparam__rects = __sklib__to_vector_rectangle(rects);
+    fill_rectangles(__skparam__clrs, __skparam__rects);
+}
+void __sklib__fill_rectangles__vector_color_ref__vector_rectangle_ref__drawing_options(const __sklib_vector_color clrs, const __sklib_vector_rectangle rects, __sklib_drawing_options opts) {
+    vector<color> __skparam__clrs = __sklib__to_vector_color(clrs);
+    vector<rectangle> __skparam__rects = __sklib__to_vector_rectangle(rects);
+    drawing_options __skparam__opts = __sklib__to_drawing_options(opts);
+    fill_rectangles(__skparam__clrs, __skparam__rects, __skparam__opts);
+}
 __sklib_rectangle __sklib__current_clip() {
     rectangle __skreturn = current_clip();
     return __sklib__to_sklib_rectangle(__skreturn);
@@ -4224,6 +4246,17 @@ void __sklib__draw_line_on_window__window__color__double__double__double__double
     drawing_options __skparam__opts = __sklib__to_drawing_options(opts);
     draw_line_on_window(__skparam__destination, __skparam__clr, __skparam__x1, __skparam__y1, __skparam__x2, __skparam__y2, __skparam__opts);
 }
+void __sklib__draw_lines__vector_color_ref__vector_line_ref(const __sklib_vector_color clrs, const __sklib_vector_line lines) {
+    vector<color> __skparam__clrs = __sklib__to_vector_color(clrs);
+    vector<line> __skparam__lines = __sklib__to_vector_line(lines);
+    draw_lines(__skparam__clrs, __skparam__lines);
+}
+void __sklib__draw_lines__vector_color_ref__vector_line_ref__drawing_options(const __sklib_vector_color clrs, const __sklib_vector_line lines, __sklib_drawing_options opts) {
+    vector<color> __skparam__clrs = __sklib__to_vector_color(clrs);
+    vector<line> __skparam__lines = __sklib__to_vector_line(lines);
+    drawing_options __skparam__opts = __sklib__to_drawing_options(opts);
+    draw_lines(__skparam__clrs, __skparam__lines, __skparam__opts);
+}
 void __sklib__call_for_all_sprites__sprite_float_function_ptr__float(__sklib_sprite_float_function *fn, float val) {
     sprite_float_function *__skparam__fn = fn;
     float __skparam__val = __sklib__to_float(val);
@@ -168,6 +168,27 @@ typedef struct {
     unsigned int size_from_lib;
 } __sklib_vector_bool;
 void __sklib__free__sklib_vector_bool(__sklib_vector_bool v);
+typedef struct {
+    __sklib_color *data_from_app;
+    unsigned int size_from_app;
+    __sklib_color *data_from_lib;
+    unsigned int size_from_lib;
+} __sklib_vector_color;
+void __sklib__free__sklib_vector_color(__sklib_vector_color v);
+typedef struct {
+    __sklib_circle *data_from_app;
+    unsigned int size_from_app;
+    __sklib_circle *data_from_lib;
+    unsigned int size_from_lib;
+} __sklib_vector_circle;
+void __sklib__free__sklib_vector_circle(__sklib_vector_circle v);
+typedef struct {
+    __sklib_rectangle *data_from_app;
+    unsigned int size_from_app;
+    __sklib_rectangle *data_from_lib;
+    unsigned int size_from_lib;
+} __sklib_vector_rectangle;
+void __sklib__free__sklib_vector_rectangle(__sklib_vector_rectangle v);
 __sklib_timer __sklib__create_timer__string(__sklib_string name);
 void __sklib__free_all_timers();
 void __sklib__free_timer__timer(__sklib_timer to_free);
@@ -249,6 +270,8 @@ void __sklib__fill_circle_on_bitmap__bitmap__color__double__double__double(__skl
 void __sklib__fill_circle_on_bitmap__bitmap__color__double__double__double__drawing_options(__sklib_bitmap destination, __sklib_color clr, double x, double y, double radius, __sklib_drawing_options opts);
 void __sklib__fill_circle_on_window__window__color__double__double__double(__sklib_window destination, __sklib_color clr, double x, double y, double radius);
 void __sklib__fill_circle_on_window__window__color__double__double__double__drawing_options(__sklib_window destination, __sklib_color clr, double x, double y, double radius, __sklib_drawing_options opts);
+void __sklib__fill_circles__vector_color_ref__vector_circle_ref(const __sklib_vector_color clrs, const __sklib_vector_circle circles);
+void __sklib__fill_circles__vector_color_ref__vector_circle_ref__drawing_options(const __sklib_vector_color clrs, const __sklib_vector_circle circles, __sklib_drawing_options opts);
 unsigned int __sklib__current_ticks();
 void __sklib__delay__unsigned_int(unsigned int milliseconds);
 void __sklib__display_dialog__string_ref__string_ref__font__int(const __sklib_string title, const __sklib_string msg, __sklib_font output_font, int font_size);
@@ -386,6 +409,8 @@ void __sklib__fill_rectangle_on_window__window__color__rectangle_ref(__sklib_win
 void __sklib__fill_rectangle_on_window__window__color__rectangle_ref__drawing_options_ref(__sklib_window destination, __sklib_color clr, const __sklib_rectangle rect, const __sklib_drawing_options opts);
 void __sklib__fill_rectangle_on_window__window__color__double__double__double__double(__sklib_window destination, __sklib_color clr, double x, double y, double width, double height);
 void __sklib__fill_rectangle_on_window__window__color__double__double__double__double__drawing_options_ref(__sklib_window destination, __sklib_color clr, double x, double y, double width, double height, const __sklib_drawing_options opts);
+void __sklib__fill_rectangles__vector_color_ref__vector_rectangle_ref(const __sklib_vector_color clrs, const __sklib_vector_rectangle rects);
+void __sklib__fill_rectangles__vector_color_ref__vector_rectangle_ref__drawing_options(const __sklib_vector_color clrs, const __sklib_vector_rectangle rects, __sklib_drawing_options opts);
 __sklib_rectangle __sklib__current_clip();
 __sklib_rectangle __sklib__current_clip__bitmap(__sklib_bitmap bmp);
 __sklib_rectangle __sklib__current_clip__window(__sklib_window wnd);
@@ -939,6 +964,8 @@ void __sklib__draw_line_on_window__window__color__point_2d_ref__point_2d_ref(__s
 void __sklib__draw_line_on_window__window__color__point_2d_ref__point_2d_ref__drawing_options_ref(__sklib_window destination, __sklib_color clr, const __sklib_point_2d from_pt, const __sklib_point_2d to_pt, const __sklib_drawing_options opts);
 void __sklib__draw_line_on_window__window__color__double__double__double__double(__sklib_window destination, __sklib_color clr, double x1, double y1, double x2, double y2);
 void __sklib__draw_line_on_window__window__color__double__double__double__double__drawing_options_ref(__sklib_window destination, __sklib_color clr, double x1, double y1, double x2, double y2, const __sklib_drawing_options opts);
+void __sklib__draw_lines__vector_color_ref__vector_line_ref(const __sklib_vector_color clrs, const __sklib_vector_line lines);
+void __sklib__draw_lines__vector_color_ref__vector_line_ref__drawing_options(const __sklib_vector_color clrs, const __sklib_vector_line lines, __sklib_drawing_options opts);
 void __sklib__call_for_all_sprites__sprite_float_function_ptr__float(__sklib_sprite_float_function *fn, float val);
 void __sklib__call_for_all_sprites__sprite_function_ptr(__sklib_sprite_function *fn);
 void __sklib__call_on_sprite_event__sprite_event_handler_ptr(__sklib_sprite_event_handler *handler);